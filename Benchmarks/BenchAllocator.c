@@ -0,0 +1,77 @@
+#include "BenchmarkSuite.h"
+
+#define main allocatorDemoMain
+#include "../DynamicMemoryAllocation/ImplementCustomMemoryAllocator.c"
+#undef main
+
+/*
+   my_malloc + my_free of 'size' bytes from the 1 KB pool. The distribution is the state of the pool:
+   - random: about half the pool held by small blocks at random places, so the first fit is a scan away.
+   - worst: free runs one byte too short for the request, separated by single allocated bytes, so every
+     start position is scanned almost to the end of the request before it fails; only the tail fits.
+   Requests of more than half the pool are skipped.
+*/
+typedef struct {
+    size_t size;
+} AllocatorState;
+
+static void* setupMalloc(const BenchInput* input, size_t* bytesPerOp) {
+    size_t size = input->size;
+    if(size == 0 || size > MEMORY_POOL_SIZE / 2 || input->distribution == DIST_TEXT) {
+        return NULL;
+    }
+    my_free(memory_chunk, MEMORY_POOL_SIZE);
+
+    // Fill the pool one byte at a time, then free the holes
+    while(my_malloc(1) != NULL) {
+    }
+    uint64_t seed = input->seed;
+    if(input->distribution == DIST_RANDOM) {
+        for(size_t i = 0; i < MEMORY_POOL_SIZE; ) {
+            size_t run = 1 + benchRandom(&seed) % 16;
+            if(benchRandom(&seed) & 1) {
+                my_free(memory_chunk + i, i + run <= MEMORY_POOL_SIZE ? run : MEMORY_POOL_SIZE - i);
+            }
+            i += run;
+        }
+        my_free(memory_chunk + MEMORY_POOL_SIZE - 2 * size, 2 * size);
+    }
+    else {
+        size_t tail = MEMORY_POOL_SIZE - size - 1;
+        for(size_t i = 0; i + size <= tail; i += size) {
+            my_free(memory_chunk + i, size - 1);
+        }
+        my_free(memory_chunk + tail, size);
+    }
+
+    void* probe = my_malloc(size);
+    if(probe == NULL) {
+        return NULL;
+    }
+    my_free(probe, size);
+
+    AllocatorState* st = benchAlloc(sizeof(AllocatorState));
+    st->size = size;
+    *bytesPerOp = size;
+    return st;
+}
+
+static void runMalloc(void* state, size_t iterations) {
+    AllocatorState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        void* p = my_malloc(st->size);
+        BENCH_KEEP(p);
+        my_free(p, st->size);
+    }
+}
+
+static void teardownMalloc(void* state) {
+    my_free(memory_chunk, MEMORY_POOL_SIZE);
+    free(state);
+}
+
+void registerAllocatorBenchmarks(void) {
+    Benchmark bench = {"my_malloc+my_free", "DynamicMemoryAllocation/ImplementCustomMemoryAllocator.c",
+                       setupMalloc, runMalloc, teardownMalloc};
+    registerBenchmark(&bench);
+}
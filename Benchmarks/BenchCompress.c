@@ -0,0 +1,55 @@
+#include "BenchmarkSuite.h"
+
+#define main compressDemoMain
+#define readString compressReadString
+#include "../StringOperations/CompressString.c"
+#undef readString
+#undef main
+
+/*
+   compressString ("aaabbc" -> "a3b2c1") over 'size' bytes, freeing the result when one is returned.
+   - random / text: few runs longer than one byte, so the output is discarded as longer than the input.
+   - worst: "abab...", every run is one byte and the encoder does the most work per input byte.
+   A string of one long run is the best case and is not measured.
+*/
+typedef struct {
+    char* input;
+} CompressState;
+
+static void* setupCompress(const BenchInput* input, size_t* bytesPerOp) {
+    CompressState* st = benchAlloc(sizeof(CompressState));
+    uint64_t seed = input->seed;
+    st->input = benchAlloc(input->size + 1);
+    benchFill(st->input, input->size, input->distribution, &seed);
+    if(input->distribution == DIST_WORST) {
+        for(size_t i = 1; i < input->size; i += 2) {
+            st->input[i] = 'b';
+        }
+    }
+    st->input[input->size] = '\0';
+    *bytesPerOp = input->size;
+    return st;
+}
+
+static void runCompress(void* state, size_t iterations) {
+    CompressState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        char* compressed = compressString(st->input);
+        BENCH_KEEP(compressed);
+        if(compressed != st->input) {
+            free(compressed);
+        }
+    }
+}
+
+static void teardownCompress(void* state) {
+    CompressState* st = state;
+    free(st->input);
+    free(st);
+}
+
+void registerCompressBenchmarks(void) {
+    Benchmark bench = {"compressString", "StringOperations/CompressString.c",
+                       setupCompress, runCompress, teardownCompress};
+    registerBenchmark(&bench);
+}
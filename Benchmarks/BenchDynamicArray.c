@@ -0,0 +1,111 @@
+#include "BenchmarkSuite.h"
+
+#define main dynamicArrayDemoMain
+#include "../PointerManipulations/DynamicArrayLibrary.c"
+#undef main
+
+/*
+   addElement: one operation builds an array of size / sizeof(int) ints from capacity 1, so it
+   includes every doubling resize, then destroys it. Only the random distribution applies.
+*/
+typedef struct {
+    size_t count;
+    int* values;
+} AddState;
+
+static void* setupAdd(const BenchInput* input, size_t* bytesPerOp) {
+    size_t count = input->size / sizeof(int);
+    if(count == 0 || input->distribution != DIST_RANDOM) {
+        return NULL;
+    }
+    AddState* st = benchAlloc(sizeof(AddState));
+    st->count = count;
+    st->values = benchAlloc(count * sizeof(int));
+    uint64_t seed = input->seed;
+    for(size_t i = 0; i < count; ++i) {
+        st->values[i] = (int)benchRandom(&seed);
+    }
+    *bytesPerOp = count * sizeof(int);
+    return st;
+}
+
+static void runAdd(void* state, size_t iterations) {
+    AddState* st = state;
+    for(size_t it = 0; it < iterations; ++it) {
+        DynamicArray* arr = init(sizeof(int), 1);
+        for(size_t i = 0; i < st->count; ++i) {
+            addElement(arr, &st->values[i]);
+        }
+        BENCH_KEEP(arr->data);
+        destroy(arr);
+    }
+}
+
+static void teardownAdd(void* state) {
+    AddState* st = state;
+    free(st->values);
+    free(st);
+}
+
+/*
+   removeElement: one operation removes one element and appends one, so the array stays at
+   size / sizeof(int) ints. The distribution picks the index, which decides how much memmove shifts:
+   - random: a uniformly random index, half the array on average.
+   - worst: always index 0, the whole array.
+*/
+#define INDEX_RING 4096
+
+typedef struct {
+    DynamicArray* arr;
+    size_t indices[INDEX_RING];
+    size_t next;
+} RemoveState;
+
+static void* setupRemove(const BenchInput* input, size_t* bytesPerOp) {
+    size_t count = input->size / sizeof(int);
+    if(count == 0 || input->distribution == DIST_TEXT) {
+        return NULL;
+    }
+    RemoveState* st = benchAlloc(sizeof(RemoveState));
+    st->arr = init(sizeof(int), count);
+    st->next = 0;
+    uint64_t seed = input->seed;
+    for(size_t i = 0; i < count; ++i) {
+        int value = (int)i;
+        addElement(st->arr, &value);
+    }
+    size_t shifted = 0;
+    for(size_t i = 0; i < INDEX_RING; ++i) {
+        st->indices[i] = input->distribution == DIST_WORST ? 0 : benchRandom(&seed) % count;
+        shifted += count - st->indices[i] - 1;
+    }
+    *bytesPerOp = shifted / INDEX_RING * sizeof(int);
+    return st;
+}
+
+static void runRemove(void* state, size_t iterations) {
+    RemoveState* st = state;
+    for(size_t it = 0; it < iterations; ++it) {
+        size_t index = st->indices[st->next];
+        st->next = (st->next + 1) % INDEX_RING;
+        int value = (int)it;
+        removeElement(st->arr, index);
+        addElement(st->arr, &value);
+    }
+    BENCH_KEEP(st->arr->data);
+}
+
+static void teardownRemove(void* state) {
+    RemoveState* st = state;
+    destroy(st->arr);
+    free(st);
+}
+
+void registerDynamicArrayBenchmarks(void) {
+    Benchmark adding = {"addElement", "PointerManipulations/DynamicArrayLibrary.c",
+                        setupAdd, runAdd, teardownAdd};
+    Benchmark removing = {"removeElement", "PointerManipulations/DynamicArrayLibrary.c",
+                          setupRemove, runRemove, teardownRemove};
+    registerBenchmark(&adding);
+    registerBenchmark(&removing);
+}
@@ -0,0 +1,68 @@
+#include "BenchmarkSuite.h"
+
+#define main palindromeDemoMain
+#define readString palindromeReadString
+#include "../StringOperations/PalindromeChecker.c"
+#undef readString
+#undef main
+
+/*
+   isPalindrome over 'size' bytes:
+   - random: printable ASCII, which usually differs at the first pair of letters and exits at once.
+   - text: words mirrored around the middle with every third letter of the second half upper-cased,
+     a palindrome only once case is ignored, so the whole string is compared.
+   - worst: random letters mirrored exactly, a palindrome compared end to end.
+*/
+typedef struct {
+    char* input;
+} PalindromeState;
+
+static void* setupPalindrome(const BenchInput* input, size_t* bytesPerOp) {
+    PalindromeState* st = benchAlloc(sizeof(PalindromeState));
+    uint64_t seed = input->seed;
+    size_t n = input->size;
+    st->input = benchAlloc(n + 1);
+    if(input->distribution == DIST_RANDOM) {
+        benchFill(st->input, n, DIST_RANDOM, &seed);
+    }
+    else {
+        if(input->distribution == DIST_TEXT) {
+            benchFill(st->input, (n + 1) / 2, DIST_TEXT, &seed);
+        }
+        else {
+            for(size_t i = 0; i < (n + 1) / 2; ++i) {
+                st->input[i] = (char)('a' + benchRandom(&seed) % 26);
+            }
+        }
+        for(size_t i = 0; i < n / 2; ++i) {
+            char c = st->input[i];
+            if(input->distribution == DIST_TEXT && i % 3 == 0 && c >= 'a' && c <= 'z') {
+                c = (char)(c - 'a' + 'A');
+            }
+            st->input[n - 1 - i] = c;
+        }
+    }
+    st->input[n] = '\0';
+    *bytesPerOp = n;
+    return st;
+}
+
+static void runPalindrome(void* state, size_t iterations) {
+    PalindromeState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        int result = isPalindrome(st->input);
+        BENCH_KEEP(result);
+    }
+}
+
+static void teardownPalindrome(void* state) {
+    PalindromeState* st = state;
+    free(st->input);
+    free(st);
+}
+
+void registerPalindromeBenchmarks(void) {
+    Benchmark bench = {"isPalindrome", "StringOperations/PalindromeChecker.c",
+                       setupPalindrome, runPalindrome, teardownPalindrome};
+    registerBenchmark(&bench);
+}
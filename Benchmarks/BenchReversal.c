@@ -0,0 +1,47 @@
+#include "BenchmarkSuite.h"
+
+#define main reversalDemoMain
+#include "../StringOperations/StringReversal.c"
+#undef main
+
+/*
+   reverse_string: strlen, a malloc of 'size' + 1 bytes, the reversed copy and the free. The content
+   doesn't change the work, so only the random distribution is measured.
+*/
+typedef struct {
+    char* input;
+} ReversalState;
+
+static void* setupReversal(const BenchInput* input, size_t* bytesPerOp) {
+    if(input->distribution != DIST_RANDOM) {
+        return NULL;
+    }
+    ReversalState* st = benchAlloc(sizeof(ReversalState));
+    uint64_t seed = input->seed;
+    st->input = benchAlloc(input->size + 1);
+    benchFill(st->input, input->size, DIST_RANDOM, &seed);
+    st->input[input->size] = '\0';
+    *bytesPerOp = input->size;
+    return st;
+}
+
+static void runReversal(void* state, size_t iterations) {
+    ReversalState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        char* reversed = reverse_string(st->input);
+        BENCH_KEEP(reversed);
+        free(reversed);
+    }
+}
+
+static void teardownReversal(void* state) {
+    ReversalState* st = state;
+    free(st->input);
+    free(st);
+}
+
+void registerReversalBenchmarks(void) {
+    Benchmark bench = {"reverse_string", "StringOperations/StringReversal.c",
+                       setupReversal, runReversal, teardownReversal};
+    registerBenchmark(&bench);
+}
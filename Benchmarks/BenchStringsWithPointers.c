@@ -0,0 +1,82 @@
+#include "BenchmarkSuite.h"
+
+#define main stringsDemoMain
+#include "../PointerManipulations/StringsWithPointers.c"
+#undef main
+
+/*
+   stringLength, stringCopy and stringConcat on strings of 'size' bytes. The scans don't look at the
+   characters, only at where the string starts, so the distribution is the alignment instead:
+   - random: the string starts on a 64-byte boundary.
+   - worst: it starts 1 byte before one, so the first block holds a single character and every
+     later block is read from the next boundary on.
+   stringConcat appends the second half of the input to a destination holding the first half.
+*/
+typedef struct {
+    char* memory;
+    char* src;
+    char* dest;
+    size_t length;
+} StringsState;
+
+static void* setupStrings(const BenchInput* input, size_t* bytesPerOp) {
+    if(input->distribution == DIST_TEXT) {
+        return NULL;
+    }
+    StringsState* st = benchAlloc(sizeof(StringsState));
+    uint64_t seed = input->seed;
+    size_t offset = input->distribution == DIST_WORST ? 63 : 0;
+    st->length = input->size;
+    st->memory = benchAlloc(2 * (input->size + 128));
+    char* aligned = (char*)(((uintptr_t)st->memory + 63) & ~(uintptr_t)63);
+    st->src = aligned + offset;
+    st->dest = aligned + input->size + 128 + offset;
+    benchFill(st->src, input->size, DIST_RANDOM, &seed);
+    st->src[input->size] = '\0';
+    *bytesPerOp = input->size;
+    return st;
+}
+
+static void runStringLength(void* state, size_t iterations) {
+    StringsState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        int length = stringLength(st->src);
+        BENCH_KEEP(length);
+    }
+}
+
+static void runStringCopy(void* state, size_t iterations) {
+    StringsState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        stringCopy(st->dest, st->src);
+        BENCH_KEEP(st->dest);
+    }
+}
+
+static void runStringConcat(void* state, size_t iterations) {
+    StringsState* st = state;
+    size_t half = st->length / 2;
+    memcpy(st->dest, st->src, half);
+    for(size_t i = 0; i < iterations; ++i) {
+        st->dest[half] = '\0';
+        stringConcat(st->dest, st->src + half);
+        BENCH_KEEP(st->dest);
+    }
+}
+
+static void teardownStrings(void* state) {
+    StringsState* st = state;
+    free(st->memory);
+    free(st);
+}
+
+void registerStringsWithPointersBenchmarks(void) {
+    Benchmark benches[] = {
+        {"stringLength", "PointerManipulations/StringsWithPointers.c", setupStrings, runStringLength, teardownStrings},
+        {"stringCopy", "PointerManipulations/StringsWithPointers.c", setupStrings, runStringCopy, teardownStrings},
+        {"stringConcat", "PointerManipulations/StringsWithPointers.c", setupStrings, runStringConcat, teardownStrings}
+    };
+    for(size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); ++i) {
+        registerBenchmark(&benches[i]);
+    }
+}
@@ -0,0 +1,50 @@
+#include "BenchmarkSuite.h"
+
+#define main strstrDemoMain
+#define readString strstrReadString
+#include "../StringOperations/strstrImplementation.c"
+#undef readString
+#undef main
+
+/*
+   my_strstr over a haystack of 'size' bytes with a needle that does not occur, so the whole haystack
+   is scanned:
+   - random / text: the needle starts with DEL (0x7f), which the generator never produces.
+   - worst: the haystack is all 'a' and the needle is 15 'a' followed by 'b', so the naive search
+     compares 16 characters at every position.
+*/
+typedef struct {
+    char* haystack;
+    const char* needle;
+} StrstrState;
+
+static void* setupStrstr(const BenchInput* input, size_t* bytesPerOp) {
+    StrstrState* st = benchAlloc(sizeof(StrstrState));
+    uint64_t seed = input->seed;
+    st->haystack = benchAlloc(input->size + 1);
+    benchFill(st->haystack, input->size, input->distribution, &seed);
+    st->haystack[input->size] = '\0';
+    st->needle = input->distribution == DIST_WORST ? "aaaaaaaaaaaaaaab" : "\x7f" "zebra";
+    *bytesPerOp = input->size;
+    return st;
+}
+
+static void runStrstr(void* state, size_t iterations) {
+    StrstrState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        char* found = my_strstr(st->haystack, st->needle);
+        BENCH_KEEP(found);
+    }
+}
+
+static void teardownStrstr(void* state) {
+    StrstrState* st = state;
+    free(st->haystack);
+    free(st);
+}
+
+void registerStrstrBenchmarks(void) {
+    Benchmark bench = {"my_strstr", "StringOperations/strstrImplementation.c",
+                       setupStrstr, runStrstr, teardownStrstr};
+    registerBenchmark(&bench);
+}
@@ -0,0 +1,146 @@
+#include "BenchmarkSuite.h"
+
+#define main editorDemoMain
+#include "../PointerManipulations/SimpleTextEditor.c"
+#undef main
+
+/*
+   Gap buffer operations on a buffer holding 'size' bytes.
+   - insertText+deleteText: one operation inserts 8 bytes and deletes them again, so the text keeps its
+     size. The distribution is where the edits land, which decides how far the gap moves:
+     random anywhere, text near the previous edit (typing), worst alternately at the start and the end.
+   - searchWord, without and with the trigram index, for a word that isn't in the text; in the worst
+     case the text is all 'a' and the word "aaab", which matches 3 bytes at every position.
+   - lineOfPosition at random positions in text.
+   - replaceAll of "the" by "THE" in text, and back on the next operation.
+   Operations whose cost doesn't grow with the text report 8 or 0 bytes per operation.
+*/
+#define POSITION_RING 4096
+
+typedef struct {
+    GapBuffer* buf;
+    const char* word;
+    size_t positions[POSITION_RING];
+    size_t next;
+} EditorState;
+
+static EditorState* createEditorState(const BenchInput* input, Distribution content) {
+    EditorState* st = benchAlloc(sizeof(EditorState));
+    uint64_t seed = input->seed;
+    char* text = benchAlloc(input->size + 1);
+    benchFill(text, input->size, content, &seed);
+    text[input->size] = '\0';
+    st->buf = createBuffer(text);
+    free(text);
+    st->word = content == DIST_WORST ? "aaab" : "zebra";
+    st->next = 0;
+
+    size_t length = input->size + 1;
+    size_t cursor = benchRandom(&seed) % length;
+    for(size_t i = 0; i < POSITION_RING; ++i) {
+        if(input->distribution == DIST_WORST) {
+            st->positions[i] = i % 2 ? input->size : 0;
+        }
+        else if(input->distribution == DIST_TEXT) {
+            cursor = (cursor + length + benchRandom(&seed) % 33 - 16) % length;
+            st->positions[i] = cursor;
+        }
+        else {
+            st->positions[i] = benchRandom(&seed) % length;
+        }
+    }
+    return st;
+}
+
+static size_t nextPosition(EditorState* st) {
+    size_t position = st->positions[st->next];
+    st->next = (st->next + 1) % POSITION_RING;
+    return position;
+}
+
+static void teardownEditor(void* state) {
+    EditorState* st = state;
+    destroyBuffer(st->buf);
+    free(st);
+}
+
+static void* setupEdit(const BenchInput* input, size_t* bytesPerOp) {
+    *bytesPerOp = 8;
+    return createEditorState(input, DIST_TEXT);
+}
+
+static void runEdit(void* state, size_t iterations) {
+    EditorState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        size_t position = nextPosition(st);
+        insertText(st->buf, "editing ", position);
+        deleteText(st->buf, position, 8);
+    }
+}
+
+static void* setupSearch(const BenchInput* input, size_t* bytesPerOp) {
+    *bytesPerOp = input->size;
+    return createEditorState(input, input->distribution);
+}
+
+static void* setupIndexedSearch(const BenchInput* input, size_t* bytesPerOp) {
+    EditorState* st = setupSearch(input, bytesPerOp);
+    enableSearchIndex(st->buf);
+    return st;
+}
+
+static void runSearch(void* state, size_t iterations) {
+    EditorState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        long position = searchWord(st->buf, st->word);
+        BENCH_KEEP(position);
+    }
+}
+
+static void* setupLineLookup(const BenchInput* input, size_t* bytesPerOp) {
+    if(input->distribution != DIST_RANDOM) {
+        return NULL;
+    }
+    *bytesPerOp = 0;
+    return createEditorState(input, DIST_TEXT);
+}
+
+static void runLineLookup(void* state, size_t iterations) {
+    EditorState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        size_t column;
+        size_t line = lineOfPosition(st->buf, nextPosition(st), &column);
+        BENCH_KEEP(line + column);
+    }
+}
+
+static void* setupReplace(const BenchInput* input, size_t* bytesPerOp) {
+    if(input->distribution != DIST_TEXT) {
+        return NULL;
+    }
+    *bytesPerOp = input->size;
+    return createEditorState(input, DIST_TEXT);
+}
+
+static void runReplace(void* state, size_t iterations) {
+    EditorState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        size_t count = st->next % 2 ? replaceAll(st->buf, "THE", "the") : replaceAll(st->buf, "the", "THE");
+        st->next++;
+        BENCH_KEEP(count);
+    }
+}
+
+void registerTextEditorBenchmarks(void) {
+    Benchmark benches[] = {
+        {"insertText+deleteText", "PointerManipulations/SimpleTextEditor.c", setupEdit, runEdit, teardownEditor},
+        {"searchWord", "PointerManipulations/SimpleTextEditor.c", setupSearch, runSearch, teardownEditor},
+        {"searchWord/indexed", "PointerManipulations/SimpleTextEditor.c",
+         setupIndexedSearch, runSearch, teardownEditor},
+        {"lineOfPosition", "PointerManipulations/SimpleTextEditor.c", setupLineLookup, runLineLookup, teardownEditor},
+        {"replaceAll", "PointerManipulations/SimpleTextEditor.c", setupReplace, runReplace, teardownEditor}
+    };
+    for(size_t i = 0; i < sizeof(benches) / sizeof(benches[0]); ++i) {
+        registerBenchmark(&benches[i]);
+    }
+}
@@ -0,0 +1,62 @@
+#include "BenchmarkSuite.h"
+
+#define main tokenizerDemoMain
+#define readString tokenizerReadString
+#include "../StringOperations/CustomStringTokenizer.c"
+#undef readString
+#undef main
+
+/*
+   customStrtok splitting 'size' bytes on spaces, newlines and punctuation. It writes terminators into
+   the string, so every operation first copies the input back; the copy is part of the time reported.
+   - random: printable ASCII, where delimiters are rare and tokens long.
+   - text: words, a token every few bytes.
+   - worst: "a a a ...", a one-byte token at every other byte.
+*/
+typedef struct {
+    char* input;
+    char* work;
+    size_t length;
+} TokenizerState;
+
+static void* setupTokenizer(const BenchInput* input, size_t* bytesPerOp) {
+    TokenizerState* st = benchAlloc(sizeof(TokenizerState));
+    uint64_t seed = input->seed;
+    st->length = input->size;
+    st->input = benchAlloc(input->size + 1);
+    st->work = benchAlloc(input->size + 1);
+    benchFill(st->input, input->size, input->distribution, &seed);
+    if(input->distribution == DIST_WORST) {
+        for(size_t i = 1; i < input->size; i += 2) {
+            st->input[i] = ' ';
+        }
+    }
+    st->input[input->size] = '\0';
+    *bytesPerOp = input->size;
+    return st;
+}
+
+static void runTokenizer(void* state, size_t iterations) {
+    TokenizerState* st = state;
+    for(size_t i = 0; i < iterations; ++i) {
+        memcpy(st->work, st->input, st->length + 1);
+        size_t tokens = 0;
+        for(char* token = customStrtok(st->work, " \n,.;"); token != NULL; token = customStrtok(NULL, " \n,.;")) {
+            tokens++;
+        }
+        BENCH_KEEP(tokens);
+    }
+}
+
+static void teardownTokenizer(void* state) {
+    TokenizerState* st = state;
+    free(st->input);
+    free(st->work);
+    free(st);
+}
+
+void registerTokenizerBenchmarks(void) {
+    Benchmark bench = {"customStrtok", "StringOperations/CustomStringTokenizer.c",
+                       setupTokenizer, runTokenizer, teardownTokenizer};
+    registerBenchmark(&bench);
+}
@@ -0,0 +1,390 @@
+/*
+Benchmark driver: runs the hot routines of the repository over several input sizes and distributions
+and reports ns/op, bytes/s and the spread between repeated samples as JSON.
+
+Build (from the repository root):
+    gcc -O2 -march=native -pthread Benchmarks/Bench*.c -o benchmarks -lm
+
+Usage:
+    ./benchmarks [--filter name] [--sizes 64,4096,262144] [--distributions random,text,worst]
+                 [--repeat 15] [--warmup-ms 50] [--sample-ms 10] [--cpu N] [--output file.json] [--list]
+
+The JSON goes to stdout (or --output), a readable table to stderr.
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+
+#include "BenchmarkSuite.h"
+
+#define MAX_BENCHMARKS 64
+#define MAX_SIZES 16
+
+static Benchmark benchmarks[MAX_BENCHMARKS];
+static int benchmarkCount = 0;
+
+static const char* distributionNames[DIST_COUNT] = {"random", "text", "worst"};
+
+void registerBenchmark(const Benchmark* bench) {
+    if(benchmarkCount == MAX_BENCHMARKS) {
+        fprintf(stderr, "Too many benchmarks, raise MAX_BENCHMARKS\n");
+        exit(1);
+    }
+    benchmarks[benchmarkCount++] = *bench;
+}
+
+void* benchAlloc(size_t size) {
+    void* p = malloc(size ? size : 1);
+    if(p == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    return p;
+}
+
+// splitmix64
+uint64_t benchRandom(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/*
+   - random: every byte drawn uniformly from the 95 printable characters.
+   - text: words from a small vocabulary weighted towards short common ones, a space between words and
+     a newline roughly every 70 characters, which is what the tokenizer, editor and compressor expect.
+   - worst: a single run of 'a'; benchmarks with a different pathological case build it themselves.
+*/
+void benchFill(char* dest, size_t length, Distribution distribution, uint64_t* seed) {
+    static const char* words[] = {
+        "the", "of", "and", "to", "a", "in", "is", "it", "that", "for", "on", "was", "with", "as",
+        "pointer", "memory", "string", "buffer", "allocate", "function", "return", "value", "array",
+        "length", "character", "performance", "program", "compiler", "variable", "structure"
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    if(distribution == DIST_RANDOM) {
+        for(size_t i = 0; i < length; ++i) {
+            dest[i] = (char)(' ' + benchRandom(seed) % 95);
+        }
+    }
+    else if(distribution == DIST_TEXT) {
+        size_t i = 0;
+        size_t column = 0;
+        while(i < length) {
+            uint64_t r = benchRandom(seed);
+            // Squaring a uniform index favours the early (short, common) words
+            size_t pick = (size_t)((r & 0xFFFF) * (r & 0xFFFF) / (0x10000ull * 0x10000ull / wordCount));
+            const char* word = words[pick < wordCount ? pick : wordCount - 1];
+            for(const char* w = word; *w != '\0' && i < length; ++w) {
+                dest[i++] = *w;
+            }
+            column += strlen(word) + 1;
+            if(i < length) {
+                dest[i++] = column > 70 ? '\n' : ' ';
+                if(column > 70) {
+                    column = 0;
+                }
+            }
+        }
+    }
+    else {
+        memset(dest, 'a', length);
+    }
+}
+
+static double nowNs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
+
+static double timeBatch(const Benchmark* bench, void* state, size_t iterations) {
+    double begin = nowNs();
+    bench->run(state, iterations);
+    return nowNs() - begin;
+}
+
+static int compareDoubles(const void* p, const void* q) {
+    double l = *(const double*)p;
+    double r = *(const double*)q;
+    return (l > r) - (l < r);
+}
+
+typedef struct {
+    double mean;
+    double median;
+    double min;
+    double max;
+    double variance;
+    double stddev;
+} Stats;
+
+static Stats computeStats(double* samples, int n) {
+    Stats s = {0};
+    qsort(samples, n, sizeof(double), compareDoubles);
+    for(int i = 0; i < n; ++i) {
+        s.mean += samples[i];
+    }
+    s.mean /= n;
+    for(int i = 0; i < n; ++i) {
+        s.variance += (samples[i] - s.mean) * (samples[i] - s.mean);
+    }
+    s.variance = n > 1 ? s.variance / (n - 1) : 0;
+    s.stddev = sqrt(s.variance);
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    s.min = samples[0];
+    s.max = samples[n - 1];
+    return s;
+}
+
+typedef struct {
+    const char* filter;
+    size_t sizes[MAX_SIZES];
+    int sizeCount;
+    int distributions[DIST_COUNT];  // Which distributions are enabled
+    int repeat;
+    double warmupNs;
+    double sampleNs;
+    int cpu;
+    const char* output;
+    int list;
+} Options;
+
+static int parseSizes(Options* opt, char* list) {
+    opt->sizeCount = 0;
+    for(char* item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        if(opt->sizeCount == MAX_SIZES) {
+            return -1;
+        }
+        opt->sizes[opt->sizeCount++] = strtoull(item, NULL, 10);
+    }
+    return opt->sizeCount > 0 ? 0 : -1;
+}
+
+static int parseDistributions(Options* opt, char* list) {
+    memset(opt->distributions, 0, sizeof(opt->distributions));
+    for(char* item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        int found = 0;
+        for(int d = 0; d < DIST_COUNT; ++d) {
+            if(strcmp(item, distributionNames[d]) == 0) {
+                opt->distributions[d] = found = 1;
+            }
+        }
+        if(!found) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int parseOptions(Options* opt, int argc, char* argv[]) {
+    for(int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if(strcmp(arg, "--list") == 0) {
+            opt->list = 1;
+            continue;
+        }
+        if(value == NULL) {
+            return -1;
+        }
+        i++;
+        if(strcmp(arg, "--filter") == 0) {
+            opt->filter = value;
+        }
+        else if(strcmp(arg, "--sizes") == 0) {
+            if(parseSizes(opt, value) != 0) {
+                return -1;
+            }
+        }
+        else if(strcmp(arg, "--distributions") == 0) {
+            if(parseDistributions(opt, value) != 0) {
+                return -1;
+            }
+        }
+        else if(strcmp(arg, "--repeat") == 0) {
+            opt->repeat = atoi(value);
+        }
+        else if(strcmp(arg, "--warmup-ms") == 0) {
+            opt->warmupNs = atof(value) * 1e6;
+        }
+        else if(strcmp(arg, "--sample-ms") == 0) {
+            opt->sampleNs = atof(value) * 1e6;
+        }
+        else if(strcmp(arg, "--cpu") == 0) {
+            opt->cpu = atoi(value);
+        }
+        else if(strcmp(arg, "--output") == 0) {
+            opt->output = value;
+        }
+        else {
+            return -1;
+        }
+    }
+    return opt->repeat > 0 && opt->sampleNs > 0 ? 0 : -1;
+}
+
+// Names and sources are plain ASCII literals, but escape anyway so the output is always valid JSON
+static void printJsonString(FILE* out, const char* s) {
+    fputc('"', out);
+    for(; *s != '\0'; ++s) {
+        if(*s == '"' || *s == '\\') {
+            fputc('\\', out);
+        }
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+/*
+   - Pinning keeps the scheduler from migrating the process between cores (cold caches, a different
+     clock speed) in the middle of a measurement. By default it stays on the CPU it started on.
+   - Each case is warmed up by running batches of growing size until warmup time has passed and one
+     batch takes at least the sample time; that batch size is then used for every sample.
+   - Each sample is the time per operation of one batch, and the statistics are over the samples, so
+     the variance shows how stable the measurement is, not how the routine varies between inputs.
+   - bytes/s is computed from the median, which a single interrupted sample can't move.
+*/
+int main(int argc, char* argv[]) {
+    Options opt = {
+        .filter = NULL,
+        .sizes = {64, 4096, 262144},
+        .sizeCount = 3,
+        .distributions = {1, 1, 1},
+        .repeat = 15,
+        .warmupNs = 50e6,
+        .sampleNs = 10e6,
+        .cpu = -1,
+        .output = NULL,
+        .list = 0
+    };
+    if(parseOptions(&opt, argc, argv) != 0) {
+        fprintf(stderr, "Usage: %s [--filter name] [--sizes n,n,...] [--distributions random,text,worst] "
+                "[--repeat n] [--warmup-ms ms] [--sample-ms ms] [--cpu n] [--output file] [--list]\n", argv[0]);
+        return 1;
+    }
+
+    registerAllocatorBenchmarks();
+    registerDynamicArrayBenchmarks();
+    registerStrstrBenchmarks();
+    registerTokenizerBenchmarks();
+    registerCompressBenchmarks();
+    registerPalindromeBenchmarks();
+    registerReversalBenchmarks();
+    registerStringsWithPointersBenchmarks();
+    registerTextEditorBenchmarks();
+
+    if(opt.list) {
+        for(int b = 0; b < benchmarkCount; ++b) {
+            printf("%-28s %s\n", benchmarks[b].name, benchmarks[b].source);
+        }
+        return 0;
+    }
+
+    if(opt.cpu < 0) {
+        opt.cpu = sched_getcpu();
+    }
+    // Without a CPU number (sched_getcpu can fail) the run goes ahead unpinned and says so
+    int pinned = 0;
+    if(opt.cpu >= 0 && opt.cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(opt.cpu, &set);
+        pinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+        if(!pinned) {
+            perror("sched_setaffinity");
+        }
+    }
+    else {
+        fprintf(stderr, "No CPU to pin to, running unpinned\n");
+    }
+
+    FILE* out = stdout;
+    if(opt.output != NULL) {
+        out = fopen(opt.output, "w");
+        if(out == NULL) {
+            perror(opt.output);
+            return 1;
+        }
+    }
+
+    double* samples = benchAlloc(opt.repeat * sizeof(double));
+    fprintf(out, "{\n  \"compiler\": ");
+    printJsonString(out, __VERSION__);
+    fprintf(out, ",\n  \"cpu\": %d,\n  \"pinned\": %s,\n  \"repeat\": %d,\n  \"timestamp\": %lld,\n  \"results\": [",
+            opt.cpu, pinned ? "true" : "false", opt.repeat, (long long)time(NULL));
+    fprintf(stderr, "%-28s %-7s %10s %14s %8s %12s\n", "benchmark", "input", "size", "ns/op", "cv", "MB/s");
+
+    int first = 1;
+    for(int b = 0; b < benchmarkCount; ++b) {
+        const Benchmark* bench = &benchmarks[b];
+        if(opt.filter != NULL && strstr(bench->name, opt.filter) == NULL) {
+            continue;
+        }
+        for(int d = 0; d < DIST_COUNT; ++d) {
+            if(!opt.distributions[d]) {
+                continue;
+            }
+            for(int s = 0; s < opt.sizeCount; ++s) {
+                // The seed depends only on the case, so a size gets the same data however --sizes is written
+                BenchInput input = {opt.sizes[s], (Distribution)d, 0x5EEDull ^ ((uint64_t)d << 56) ^ opt.sizes[s]};
+                size_t bytesPerOp = 0;
+                void* state = bench->setup(&input, &bytesPerOp);
+                if(state == NULL) {
+                    continue;
+                }
+
+                size_t iterations = 1;
+                double spent = 0;
+                for(;;) {
+                    double batch = timeBatch(bench, state, iterations);
+                    spent += batch;
+                    if(batch >= opt.sampleNs) {
+                        if(spent >= opt.warmupNs) {
+                            break;
+                        }
+                        continue;
+                    }
+                    double scale = batch > 0 ? 1.25 * opt.sampleNs / batch : 16;
+                    iterations = (size_t)(iterations * (scale < 2 ? 2 : scale > 16 ? 16 : scale));
+                }
+
+                for(int r = 0; r < opt.repeat; ++r) {
+                    samples[r] = timeBatch(bench, state, iterations) / iterations;
+                }
+                bench->teardown(state);
+
+                Stats st = computeStats(samples, opt.repeat);
+                double bytesPerSecond = st.median > 0 ? bytesPerOp * 1e9 / st.median : 0;
+
+                fprintf(out, "%s\n    {\"benchmark\": ", first ? "" : ",");
+                printJsonString(out, bench->name);
+                fprintf(out, ", \"source\": ");
+                printJsonString(out, bench->source);
+                fprintf(out, ", \"distribution\": \"%s\", \"size\": %zu, \"iterations\": %zu, \"bytes_per_op\": %zu,\n"
+                        "     \"ns_per_op\": {\"mean\": %.3f, \"median\": %.3f, \"min\": %.3f, \"max\": %.3f, "
+                        "\"stddev\": %.3f, \"variance\": %.3f},\n     \"bytes_per_second\": %.0f}",
+                        distributionNames[d], input.size, iterations, bytesPerOp,
+                        st.mean, st.median, st.min, st.max, st.stddev, st.variance, bytesPerSecond);
+                first = 0;
+
+                fprintf(stderr, "%-28s %-7s %10zu %14.1f %7.1f%% %12.1f\n", bench->name, distributionNames[d],
+                        input.size, st.median, st.mean > 0 ? 100 * st.stddev / st.mean : 0, bytesPerSecond / 1e6);
+            }
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+
+    free(samples);
+    if(out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
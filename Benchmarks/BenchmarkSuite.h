@@ -0,0 +1,57 @@
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+   Shared declarations for the benchmark driver (BenchmarkSuite.c) and the per-module files
+   (Bench*.c). Every program in this repository has its own main(), so each Bench*.c file includes
+   exactly one of them with main (and any clashing global) renamed, and registers its benchmarks here.
+*/
+
+// Shape of the generated input; each benchmark says what the three mean for its routine and may skip one
+typedef enum {
+    DIST_RANDOM,        // Uniformly random printable ASCII
+    DIST_TEXT,          // English-like words, spaces and newlines
+    DIST_WORST,         // The routine's own pathological case
+    DIST_COUNT
+} Distribution;
+
+typedef struct {
+    size_t size;                    // Input size in bytes
+    Distribution distribution;
+    uint64_t seed;                  // Same seed for every run, so runs compare like with like
+} BenchInput;
+
+typedef struct {
+    const char* name;               // Routine being measured, e.g. "my_strstr"
+    const char* source;             // File the routine comes from
+    // Builds the input and returns the state passed to run, or NULL to skip this size/distribution.
+    // *bytesPerOp is set to the number of input bytes one operation processes.
+    void* (*setup)(const BenchInput* input, size_t* bytesPerOp);
+    void (*run)(void* state, size_t iterations);    // Performs 'iterations' operations
+    void (*teardown)(void* state);
+} Benchmark;
+
+void registerBenchmark(const Benchmark* bench);
+
+// Fills 'length' bytes (no terminator) following 'distribution'; DIST_WORST fills with 'a'
+void benchFill(char* dest, size_t length, Distribution distribution, uint64_t* seed);
+uint64_t benchRandom(uint64_t* state);
+void* benchAlloc(size_t size);      // malloc that exits on failure
+
+// Keeps a result alive and stops the compiler from moving memory accesses across the call
+#define BENCH_KEEP(value) __asm__ __volatile__("" : : "r"(value) : "memory")
+
+void registerAllocatorBenchmarks(void);
+void registerDynamicArrayBenchmarks(void);
+void registerStrstrBenchmarks(void);
+void registerTokenizerBenchmarks(void);
+void registerCompressBenchmarks(void);
+void registerPalindromeBenchmarks(void);
+void registerReversalBenchmarks(void);
+void registerStringsWithPointersBenchmarks(void);
+void registerTextEditorBenchmarks(void);
+
+#endif
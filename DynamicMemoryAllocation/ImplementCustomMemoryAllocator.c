@@ -2,12 +2,16 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "../Instrumentation/Trace.h"
+
 #define MEMORY_POOL_SIZE 1024
 
 char memory_chunk[MEMORY_POOL_SIZE];
 bool allocated[MEMORY_POOL_SIZE] = {false};
 
 void* my_malloc(size_t size) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(size);
     for(int i = 0; i < MEMORY_POOL_SIZE - size; i++) {
         bool can_allocate = true;
         for(int j = 0; j < size; ++j) {
@@ -1,5 +1,15 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 // Global variable (Data segment - Initialized)
 int global_var = 42;
@@ -23,7 +33,480 @@ void displayMemoryAddresses() {
     free(heap_var);
 }
 
+/*
+   Memory footprint profiler: the addresses above say where the segments are, this says how much
+   memory each of them actually uses while the program runs.
+   - /proc/self/smaps lists every mapping of the process with its size and, per mapping, how much of
+     it is resident (Rss), the resident size with shared pages divided among the processes sharing
+     them (Pss), how much is anonymous (heap, stack, bss, copy-on-write pages) and how much is swapped.
+     Resident memory that isn't anonymous is backed by a file: code and read-only data of the program
+     and its libraries, which the kernel can drop and read back at any time.
+   - Each mapping is assigned to a segment:
+       text       the program's own read-only mappings (code, constants)
+       data       the program's writable file mapping (initialized globals and statics)
+       bss        the anonymous mapping right after the program's data (zero-initialized globals);
+                  a small bss fits in the last page of data and has no mapping of its own
+       heap       [heap], the brk area malloc grows for small blocks
+       stack      [stack], the main thread's stack
+       mmap       every other anonymous or file mapping: large malloc blocks, malloc arenas of other
+                  threads, thread stacks, mapped files
+       libraries  every mapping of a shared library
+       kernel     [vdso], [vvar] and [vsyscall]
+   - /proc/self/status adds the process-wide totals (current and peak RSS, anonymous, file and shared
+     memory, swap), and getrusage the minor and major page faults so far.
+   - Sizes are in bytes; the kernel reports them in kB.
+*/
+typedef enum {
+    SEGMENT_TEXT,
+    SEGMENT_DATA,
+    SEGMENT_BSS,
+    SEGMENT_HEAP,
+    SEGMENT_STACK,
+    SEGMENT_MMAP,
+    SEGMENT_LIBRARIES,
+    SEGMENT_KERNEL,
+    SEGMENT_COUNT
+} SegmentKind;
+
+static const char* segmentNames[SEGMENT_COUNT] = {
+    "text", "data", "bss", "heap", "stack", "mmap", "libraries", "kernel"
+};
+
+typedef struct {
+    size_t mappings;        // Number of mappings in the segment
+    size_t size;            // Address space reserved
+    size_t rss;             // Resident in memory
+    size_t pss;             // Resident, shared pages divided by the number of sharers
+    size_t anonymous;       // Resident and not backed by a file
+    size_t fileBacked;      // Resident and backed by a file: rss - anonymous
+    size_t swap;            // Swapped out
+} SegmentUsage;
+
+typedef struct {
+    SegmentUsage segments[SEGMENT_COUNT];
+    SegmentUsage total;
+    size_t vmRss;           // From /proc/self/status
+    size_t vmHwm;           // Peak RSS
+    size_t rssAnon;
+    size_t rssFile;
+    size_t rssShmem;
+    size_t vmSwap;
+    long minorFaults;       // Page faults served without I/O (first touch, copy-on-write)
+    long majorFaults;       // Page faults that had to read from disk
+} MemoryProfile;
+
+// Which segment a mapping of /proc/self/smaps belongs to; lastProgramEnd tracks where the program's mappings end
+static SegmentKind classifyMapping(const char* path, const char* perms, unsigned long start, unsigned long end,
+                                   const char* program, unsigned long* lastProgramEnd) {
+    if(strcmp(path, "[heap]") == 0) {
+        return SEGMENT_HEAP;
+    }
+    if(strncmp(path, "[stack", 6) == 0) {
+        return SEGMENT_STACK;
+    }
+    if(strncmp(path, "[anon", 5) == 0) {
+        return SEGMENT_MMAP;
+    }
+    if(path[0] == '[') {
+        return SEGMENT_KERNEL;
+    }
+    if(program[0] != '\0' && strcmp(path, program) == 0) {
+        *lastProgramEnd = end;
+        return perms[1] == 'w' ? SEGMENT_DATA : SEGMENT_TEXT;
+    }
+    if(path[0] == '\0') {
+        return start == *lastProgramEnd ? SEGMENT_BSS : SEGMENT_MMAP;
+    }
+    if(strstr(path, ".so") != NULL) {
+        return SEGMENT_LIBRARIES;
+    }
+    return SEGMENT_MMAP;
+}
+
+static int readSmaps(MemoryProfile* p) {
+    FILE* f = fopen("/proc/self/smaps", "r");
+    if(f == NULL) {
+        return -1;
+    }
+
+    char program[PATH_MAX] = "";
+    ssize_t length = readlink("/proc/self/exe", program, sizeof(program) - 1);
+    program[length > 0 ? length : 0] = '\0';
+
+    char line[PATH_MAX + 128];
+    SegmentUsage* current = NULL;
+    unsigned long lastProgramEnd = 0;
+    while(fgets(line, sizeof(line), f) != NULL) {
+        unsigned long start, end, offset, inode;
+        char perms[5];
+        int pathStart = 0;
+        // A mapping starts with "start-end perms offset dev inode path"; the lines after it are "Key: value kB"
+        if(sscanf(line, "%lx-%lx %4s %lx %*s %lu %n", &start, &end, perms, &offset, &inode, &pathStart) == 5) {
+            char* path = line + pathStart;
+            path[strcspn(path, "\n")] = '\0';
+            char* deleted = strstr(path, " (deleted)");
+            if(deleted != NULL) {
+                *deleted = '\0';
+            }
+            current = &p->segments[classifyMapping(path, perms, start, end, program, &lastProgramEnd)];
+            current->mappings++;
+            current->size += end - start;
+            continue;
+        }
+
+        char key[32];
+        size_t kb;
+        if(current == NULL || sscanf(line, "%31[^:]: %zu kB", key, &kb) != 2) {
+            continue;
+        }
+        if(strcmp(key, "Rss") == 0) {
+            current->rss += kb * 1024;
+        }
+        else if(strcmp(key, "Pss") == 0) {
+            current->pss += kb * 1024;
+        }
+        else if(strcmp(key, "Anonymous") == 0) {
+            current->anonymous += kb * 1024;
+        }
+        else if(strcmp(key, "Swap") == 0) {
+            current->swap += kb * 1024;
+        }
+    }
+    fclose(f);
+
+    for(int s = 0; s < SEGMENT_COUNT; ++s) {
+        SegmentUsage* u = &p->segments[s];
+        u->fileBacked = u->rss - u->anonymous;
+        p->total.mappings += u->mappings;
+        p->total.size += u->size;
+        p->total.rss += u->rss;
+        p->total.pss += u->pss;
+        p->total.anonymous += u->anonymous;
+        p->total.fileBacked += u->fileBacked;
+        p->total.swap += u->swap;
+    }
+    return 0;
+}
+
+typedef struct {
+    size_t vmRss;
+    size_t rssAnon;
+    size_t rssFile;
+    size_t rssShmem;
+    size_t vmHwm;
+    size_t vmSwap;
+} StatusFields;
+
+static int readStatus(StatusFields* st) {
+    FILE* f = fopen("/proc/self/status", "r");
+    if(f == NULL) {
+        return -1;
+    }
+    memset(st, 0, sizeof(StatusFields));
+    char line[256];
+    while(fgets(line, sizeof(line), f) != NULL) {
+        char key[32];
+        size_t kb;
+        if(sscanf(line, "%31[^:]: %zu kB", key, &kb) != 2) {
+            continue;
+        }
+        if(strcmp(key, "VmRSS") == 0) {
+            st->vmRss = kb * 1024;
+        }
+        else if(strcmp(key, "RssAnon") == 0) {
+            st->rssAnon = kb * 1024;
+        }
+        else if(strcmp(key, "RssFile") == 0) {
+            st->rssFile = kb * 1024;
+        }
+        else if(strcmp(key, "RssShmem") == 0) {
+            st->rssShmem = kb * 1024;
+        }
+        else if(strcmp(key, "VmHWM") == 0) {
+            st->vmHwm = kb * 1024;
+        }
+        else if(strcmp(key, "VmSwap") == 0) {
+            st->vmSwap = kb * 1024;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+// Fill p with the current footprint; returns 0, or -1 if /proc can't be read
+int takeMemoryProfile(MemoryProfile* p) {
+    memset(p, 0, sizeof(MemoryProfile));
+    StatusFields st;
+    if(readSmaps(p) != 0 || readStatus(&st) != 0) {
+        return -1;
+    }
+    p->vmRss = st.vmRss;
+    p->vmHwm = st.vmHwm;
+    p->rssAnon = st.rssAnon;
+    p->rssFile = st.rssFile;
+    p->rssShmem = st.rssShmem;
+    p->vmSwap = st.vmSwap;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    p->minorFaults = usage.ru_minflt;
+    p->majorFaults = usage.ru_majflt;
+    return 0;
+}
+
+static void printUsageRow(const char* name, const SegmentUsage* u) {
+    printf("%-10s %8zu %12zu %10zu %10zu %10zu %10zu %8zu\n", name, u->mappings, u->size / 1024, u->rss / 1024,
+           u->pss / 1024, u->anonymous / 1024, u->fileBacked / 1024, u->swap / 1024);
+}
+
+void printMemoryProfile(const MemoryProfile* p) {
+    printf("%-10s %8s %12s %10s %10s %10s %10s %8s\n", "segment", "mappings", "size kB", "rss kB",
+           "pss kB", "anon kB", "file kB", "swap kB");
+    for(int s = 0; s < SEGMENT_COUNT; ++s) {
+        printUsageRow(segmentNames[s], &p->segments[s]);
+    }
+    printUsageRow("total", &p->total);
+    printf("RSS %zu kB (peak %zu kB): anonymous %zu kB, file %zu kB, shared %zu kB, swap %zu kB\n",
+           p->vmRss / 1024, p->vmHwm / 1024, p->rssAnon / 1024, p->rssFile / 1024, p->rssShmem / 1024,
+           p->vmSwap / 1024);
+    printf("Page faults: %ld minor, %ld major\n", p->minorFaults, p->majorFaults);
+}
+
+static long long kbChange(size_t before, size_t after) {
+    return ((long long)after - (long long)before) / 1024;
+}
+
+// What changed between two profiles, e.g. before and after building a data structure
+void printMemoryProfileChange(const MemoryProfile* before, const MemoryProfile* after) {
+    printf("%-10s %12s %10s %10s %10s %10s\n", "segment", "size kB", "rss kB", "pss kB", "anon kB", "file kB");
+    for(int s = 0; s <= SEGMENT_COUNT; ++s) {
+        const SegmentUsage* b = s < SEGMENT_COUNT ? &before->segments[s] : &before->total;
+        const SegmentUsage* a = s < SEGMENT_COUNT ? &after->segments[s] : &after->total;
+        if(s < SEGMENT_COUNT && a->size == b->size && a->rss == b->rss && a->pss == b->pss) {
+            continue;
+        }
+        printf("%-10s %+12lld %+10lld %+10lld %+10lld %+10lld\n", s < SEGMENT_COUNT ? segmentNames[s] : "total",
+               kbChange(b->size, a->size), kbChange(b->rss, a->rss), kbChange(b->pss, a->pss),
+               kbChange(b->anonymous, a->anonymous), kbChange(b->fileBacked, a->fileBacked));
+    }
+    printf("Page faults: %+ld minor, %+ld major\n", after->minorFaults - before->minorFaults,
+           after->majorFaults - before->majorFaults);
+}
+
+/*
+   Sampling over time: a background thread records the footprint every intervalMs milliseconds while
+   the program runs, so heap growth can be followed through a workload instead of seen only at the end.
+   - Each sample reads /proc/self/status rather than smaps, which would take milliseconds per sample
+     on a large process.
+   - The heap is measured the way malloc sees it, with mallinfo2() on glibc: heapTotal is what malloc
+     holds from the kernel (brk heap plus mmapped blocks), heapInUse what the program has allocated
+     and not freed. Elsewhere heapTotal is only the growth of the brk heap and heapInUse is 0.
+   - When the buffer fills up, every other sample is dropped and the interval doubles, so a long run
+     still covers its whole length with the same number of samples.
+*/
+typedef struct {
+    double seconds;         // Since the sampler started
+    size_t rss;
+    size_t rssAnon;
+    size_t heapTotal;
+    size_t heapInUse;
+    long minorFaults;
+} MemorySample;
+
+typedef struct {
+    pthread_t thread;
+    atomic_int running;
+    unsigned intervalMs;
+    MemorySample* samples;
+    size_t count;
+    size_t capacity;
+    struct timespec start;
+    char* initialBreak;
+} MemorySampler;
+
+static void takeSample(MemorySampler* s, MemorySample* sample) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    sample->seconds = (now.tv_sec - s->start.tv_sec) + (now.tv_nsec - s->start.tv_nsec) / 1e9;
+
+    StatusFields st;
+    if(readStatus(&st) != 0) {
+        memset(&st, 0, sizeof(st));
+    }
+    sample->rss = st.vmRss;
+    sample->rssAnon = st.rssAnon;
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    sample->heapTotal = info.arena + info.hblkhd;
+    sample->heapInUse = info.uordblks + info.hblkhd;
+#else
+    sample->heapTotal = (size_t)((char*)sbrk(0) - s->initialBreak);
+    sample->heapInUse = 0;
+#endif
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    sample->minorFaults = usage.ru_minflt;
+}
+
+static void addSample(MemorySampler* s) {
+    if(s->count == s->capacity) {
+        for(size_t i = 0; i < s->capacity / 2; ++i) {
+            s->samples[i] = s->samples[2 * i];
+        }
+        s->count = s->capacity / 2;
+        s->intervalMs *= 2;
+    }
+    takeSample(s, &s->samples[s->count++]);
+}
+
+static void* samplerWorker(void* arg) {
+    MemorySampler* s = arg;
+    while(atomic_load(&s->running)) {
+        addSample(s);
+        struct timespec pause = {s->intervalMs / 1000, (long)(s->intervalMs % 1000) * 1000000};
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+// Start sampling every intervalMs milliseconds, keeping at most capacity samples (at least 2)
+MemorySampler* startMemorySampler(unsigned intervalMs, size_t capacity) {
+    MemorySampler* s = malloc(sizeof(MemorySampler));
+    if(s == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    s->capacity = capacity < 2 ? 2 : capacity;
+    s->samples = malloc(s->capacity * sizeof(MemorySample));
+    if(s->samples == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    s->intervalMs = intervalMs ? intervalMs : 1;
+    s->count = 0;
+    s->initialBreak = sbrk(0);
+    clock_gettime(CLOCK_MONOTONIC, &s->start);
+    atomic_store(&s->running, 1);
+    if(pthread_create(&s->thread, NULL, samplerWorker, s) != 0) {
+        free(s->samples);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+// Stop sampling, take one last sample and return them all; they stay valid until destroyMemorySampler
+const MemorySample* stopMemorySampler(MemorySampler* s, size_t* count) {
+    atomic_store(&s->running, 0);
+    pthread_join(s->thread, NULL);
+    addSample(s);
+    *count = s->count;
+    return s->samples;
+}
+
+void destroyMemorySampler(MemorySampler* s) {
+    free(s->samples);
+    free(s);
+}
+
+// Prints at most maxRows evenly spaced samples, with a bar for the heap in use
+void printMemorySamples(const MemorySample* samples, size_t count, size_t maxRows) {
+    size_t peak = 1;
+    for(size_t i = 0; i < count; ++i) {
+        size_t heap = samples[i].heapInUse ? samples[i].heapInUse : samples[i].heapTotal;
+        peak = heap > peak ? heap : peak;
+    }
+    size_t step = maxRows > 0 && count > maxRows ? (count + maxRows - 1) / maxRows : 1;
+
+    printf("%9s %10s %10s %12s %12s %10s\n", "time s", "rss kB", "anon kB", "heap kB", "in use kB", "faults");
+    for(size_t i = 0; i < count; i += step) {
+        // Always end on the last sample
+        const MemorySample* m = &samples[i + step >= count ? count - 1 : i];
+        size_t heap = m->heapInUse ? m->heapInUse : m->heapTotal;
+        char bar[41];
+        size_t width = heap * 40 / peak;
+        memset(bar, '#', width);
+        bar[width] = '\0';
+        printf("%9.3f %10zu %10zu %12zu %12zu %10ld  %s\n", m->seconds, m->rss / 1024, m->rssAnon / 1024,
+               m->heapTotal / 1024, m->heapInUse / 1024, m->minorFaults, bar);
+    }
+}
+
+/*
+   Demo workload: a linked list of small nodes (brk heap), one large buffer (mmapped by malloc), then
+   half the nodes and the buffer are freed. The profile change shows where each part went: the nodes
+   in heap, the buffer in mmap, along with the sampler thread's stack and the malloc arena it gets
+   for itself, which reserve a lot of address space but hold little memory. The samples show the
+   heap growing and shrinking.
+*/
+typedef struct Node {
+    struct Node* next;
+    char text[48];
+} Node;
+
 int main() {
     displayMemoryAddresses();
+
+    MemoryProfile before, after;
+    if(takeMemoryProfile(&before) != 0) {
+        printf("Could not read /proc/self; the profiler needs Linux\n");
+        return 1;
+    }
+    printf("\nMemory profile at start:\n");
+    printMemoryProfile(&before);
+
+    MemorySampler* sampler = startMemorySampler(2, 256);
+    if(sampler == NULL) {
+        printf("Could not start the sampler thread\n");
+        return 1;
+    }
+
+    Node* head = NULL;
+    for(int i = 0; i < 400000; ++i) {
+        Node* node = malloc(sizeof(Node));
+        if(node == NULL) {
+            printf("Memory allocation failed!!\n");
+            exit(1);
+        }
+        snprintf(node->text, sizeof(node->text), "node %d", i);
+        node->next = head;
+        head = node;
+    }
+    size_t bigSize = 32u << 20;
+    char* big = malloc(bigSize);
+    if(big == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    // Only touched pages become resident; one write per page is enough
+    for(size_t i = 0; i < bigSize; i += 4096) {
+        ((volatile char*)big)[i] = 1;
+    }
+
+    takeMemoryProfile(&after);
+    printf("\nChange after building the list and the buffer:\n");
+    printMemoryProfileChange(&before, &after);
+
+    free(big);
+    // Free every other node; the heap keeps the holes, so its RSS hardly shrinks
+    for(Node* node = head; node != NULL && node->next != NULL; node = node->next) {
+        Node* unlinked = node->next;
+        node->next = unlinked->next;
+        free(unlinked);
+    }
+
+    size_t count;
+    const MemorySample* samples = stopMemorySampler(sampler, &count);
+    printf("\nHeap over time (%zu samples):\n", count);
+    printMemorySamples(samples, count, 24);
+    destroyMemorySampler(sampler);
+
+    while(head != NULL) {
+        Node* next = head->next;
+        free(head);
+        head = next;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,440 @@
+/*
+Allocation tracker: an LD_PRELOAD library that records every malloc, calloc, realloc and free of a
+program by call site, and prints the sites that allocate the most when the program exits.
+
+Build (glibc):
+    gcc -O2 -shared -fPIC Instrumentation/AllocationTracker.c -o libAllocationTracker.so -ldl -pthread
+
+Run any program of this repository under it, no rebuild needed:
+    LD_PRELOAD=./libAllocationTracker.so ./StringReversal
+
+    ALLOC_TRACK_TOP=n         number of sites listed (default 10)
+    ALLOC_TRACK_OUTPUT=file   write the report to a file instead of stderr
+*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <dlfcn.h>
+
+/*
+   - The real allocator is glibc's, reached through __libc_malloc and friends. Looking the functions up
+     with dlsym instead would call calloc before there is anything to forward it to.
+   - A call site is the return address of the allocation call, so all allocations made by one line of
+     code are counted together. Sites are resolved to names only for the report, with dladdr.
+   - Every live block is remembered (pointer, size, site, time of allocation) in a hash table split into
+     stripes, each with its own lock, so threads allocating at the same time rarely wait for each other.
+     free() looks the block up to find its site and how long it lived.
+   - Per site: allocations, bytes, frees, blocks still live and a log2 histogram of lifetimes, all
+     updated with atomic adds. Short lifetimes are where a stack buffer or a reused buffer would do.
+   - A thread-local flag sends the tracker's own allocations (the report's stdio, dladdr) straight to
+     glibc, so they are neither tracked nor recursive.
+*/
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void* __libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void* ptr);
+
+#define MAX_SITES 4096              // Call sites tracked; later ones share the "other" slot 0
+#define LIFETIME_BUCKETS 40         // Lifetimes up to 2^40 ns, about 18 minutes
+#define STRIPES 64
+#define DEFAULT_TOP 10
+
+typedef struct {
+    _Atomic(uintptr_t) address;     // Return address of the allocation call, 0 if the slot is free
+    atomic_ullong allocations;
+    atomic_ullong bytes;
+    atomic_ullong frees;
+    atomic_ullong liveBytes;
+    atomic_ullong lifetimeNs;       // Sum over freed blocks
+    atomic_ullong lifetimes[LIFETIME_BUCKETS];
+} Site;
+
+typedef struct Block {
+    struct Block* next;
+    void* ptr;
+    size_t size;
+    uint64_t allocatedNs;
+    uint32_t site;
+} Block;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Block** buckets;
+    size_t bucketCount;             // Power of two
+    size_t count;
+    Block* spare;                   // Freed Block records, reused before asking glibc for more
+} Stripe;
+
+static Site sites[MAX_SITES];
+static Stripe stripes[STRIPES];
+static atomic_int trackerReady = 0;
+static atomic_int trackerDone = 0;
+static __thread int inTracker __attribute__((tls_model("initial-exec")));
+
+static uint64_t nowNs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+static size_t hashPointer(const void* ptr) {
+    uint64_t x = (uintptr_t)ptr;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    return (size_t)x;
+}
+
+// Slot of a call site, claimed with a compare-and-swap the first time the site allocates
+static uint32_t siteIndex(uintptr_t address) {
+    size_t mask = MAX_SITES - 1;
+    size_t i = hashPointer((void*)address) & mask;
+    for(size_t probes = 0; probes < MAX_SITES; ++probes, i = (i + 1) & mask) {
+        if(i == 0) {
+            continue;               // Reserved for "other"
+        }
+        uintptr_t current = atomic_load_explicit(&sites[i].address, memory_order_acquire);
+        if(current == address) {
+            return (uint32_t)i;
+        }
+        if(current == 0) {
+            uintptr_t expected = 0;
+            if(atomic_compare_exchange_strong(&sites[i].address, &expected, address) || expected == address) {
+                return (uint32_t)i;
+            }
+        }
+    }
+    return 0;
+}
+
+__attribute__((constructor))
+static void initTracker(void) {
+    for(int s = 0; s < STRIPES; ++s) {
+        pthread_mutex_init(&stripes[s].lock, NULL);
+    }
+    atomic_store(&trackerReady, 1);
+}
+
+// Double the buckets of a stripe; called with its lock held
+static void growStripe(Stripe* st) {
+    size_t newCount = st->bucketCount ? st->bucketCount * 2 : 256;
+    Block** newBuckets = __libc_calloc(newCount, sizeof(Block*));
+    if(newBuckets == NULL) {
+        return;                     // Keep the longer chains
+    }
+    for(size_t b = 0; b < st->bucketCount; ++b) {
+        Block* block = st->buckets[b];
+        while(block != NULL) {
+            Block* next = block->next;
+            size_t slot = (hashPointer(block->ptr) / STRIPES) & (newCount - 1);
+            block->next = newBuckets[slot];
+            newBuckets[slot] = block;
+            block = next;
+        }
+    }
+    __libc_free(st->buckets);
+    st->buckets = newBuckets;
+    st->bucketCount = newCount;
+}
+
+static void recordAllocation(void* ptr, size_t size, uintptr_t caller) {
+    if(ptr == NULL || inTracker || !atomic_load_explicit(&trackerReady, memory_order_relaxed) ||
+       atomic_load_explicit(&trackerDone, memory_order_relaxed)) {
+        return;
+    }
+    inTracker = 1;
+    uint32_t index = siteIndex(caller);
+    Site* site = &sites[index];
+    atomic_fetch_add_explicit(&site->allocations, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&site->bytes, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(&site->liveBytes, size, memory_order_relaxed);
+
+    size_t hash = hashPointer(ptr);
+    Stripe* st = &stripes[hash % STRIPES];
+    pthread_mutex_lock(&st->lock);
+    if(st->count >= st->bucketCount) {
+        growStripe(st);
+    }
+    Block* block = st->spare;
+    if(block != NULL) {
+        st->spare = block->next;
+    }
+    else {
+        block = __libc_malloc(sizeof(Block));
+    }
+    if(block != NULL && st->bucketCount > 0) {
+        block->ptr = ptr;
+        block->size = size;
+        block->site = index;
+        block->allocatedNs = nowNs();
+        size_t slot = (hash / STRIPES) & (st->bucketCount - 1);
+        block->next = st->buckets[slot];
+        st->buckets[slot] = block;
+        st->count++;
+    }
+    pthread_mutex_unlock(&st->lock);
+    inTracker = 0;
+}
+
+static void recordFree(void* ptr) {
+    if(ptr == NULL || inTracker || !atomic_load_explicit(&trackerReady, memory_order_relaxed)) {
+        return;
+    }
+    inTracker = 1;
+    size_t hash = hashPointer(ptr);
+    Stripe* st = &stripes[hash % STRIPES];
+    Block found;
+    int tracked = 0;
+
+    pthread_mutex_lock(&st->lock);
+    if(st->bucketCount > 0) {
+        Block** link = &st->buckets[(hash / STRIPES) & (st->bucketCount - 1)];
+        while(*link != NULL && (*link)->ptr != ptr) {
+            link = &(*link)->next;
+        }
+        if(*link != NULL) {
+            Block* block = *link;
+            *link = block->next;
+            found = *block;
+            block->next = st->spare;
+            st->spare = block;
+            st->count--;
+            tracked = 1;
+        }
+    }
+    pthread_mutex_unlock(&st->lock);
+
+    // Blocks allocated before the tracker started, or by the tracker itself, aren't in the table
+    if(tracked) {
+        uint64_t lifetime = nowNs() - found.allocatedNs;
+        int bucket = lifetime ? 63 - __builtin_clzll(lifetime) : 0;
+        Site* site = &sites[found.site];
+        atomic_fetch_add_explicit(&site->frees, 1, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&site->liveBytes, found.size, memory_order_relaxed);
+        atomic_fetch_add_explicit(&site->lifetimeNs, lifetime, memory_order_relaxed);
+        atomic_fetch_add_explicit(&site->lifetimes[bucket < LIFETIME_BUCKETS ? bucket : LIFETIME_BUCKETS - 1], 1,
+                                  memory_order_relaxed);
+    }
+    inTracker = 0;
+}
+
+#define CALLER ((uintptr_t)__builtin_return_address(0))
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    recordAllocation(ptr, size, CALLER);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    recordAllocation(ptr, count * size, CALLER);
+    return ptr;
+}
+
+// The old block counts as freed and the new one as allocated by the caller of realloc.
+// If realloc fails, the old block stays allocated but is no longer tracked.
+void* realloc(void* old, size_t size) {
+    recordFree(old);
+    void* ptr = __libc_realloc(old, size);
+    recordAllocation(ptr, size, CALLER);
+    return ptr;
+}
+
+void free(void* ptr) {
+    recordFree(ptr);
+    __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    recordAllocation(ptr, size, CALLER);
+    return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    recordAllocation(ptr, size, CALLER);
+    return ptr;
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if(alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if(ptr == NULL) {
+        return ENOMEM;
+    }
+    recordAllocation(ptr, size, CALLER);
+    *out = ptr;
+    return 0;
+}
+
+/*
+   Report
+   - A site is printed as "function+offset" when the symbol is exported, and always as
+     "file+offset", which `addr2line -f -e file offset` turns into the function and line (the offset
+     is that of the call instruction, not of the return address). Build with -rdynamic to get the
+     names of a program's own functions without addr2line.
+   - The table lists the top sites by allocation count, then the top sites by bytes that aren't
+     already listed, and under each site a histogram of how long its freed blocks lived.
+*/
+static void describeSite(uintptr_t address, char* out, size_t size) {
+    Dl_info info;
+    if(address == 0) {
+        snprintf(out, size, "(other sites)");
+        return;
+    }
+    if(dladdr((void*)address, &info) == 0 || info.dli_fname == NULL) {
+        snprintf(out, size, "%#lx", (unsigned long)address);
+        return;
+    }
+    const char* file = strrchr(info.dli_fname, '/');
+    file = file != NULL ? file + 1 : info.dli_fname;
+    unsigned long offset = (unsigned long)(address - 1 - (uintptr_t)info.dli_fbase);
+    if(info.dli_sname != NULL) {
+        snprintf(out, size, "%s+%#lx (%s+%#lx)", info.dli_sname,
+                 (unsigned long)(address - (uintptr_t)info.dli_saddr), file, offset);
+    }
+    else {
+        snprintf(out, size, "%s+%#lx", file, offset);
+    }
+}
+
+static int compareByAllocations(const void* p, const void* q) {
+    unsigned long long l = atomic_load(&sites[*(const int*)p].allocations);
+    unsigned long long r = atomic_load(&sites[*(const int*)q].allocations);
+    return (l < r) - (l > r);
+}
+
+static int compareByBytes(const void* p, const void* q) {
+    unsigned long long l = atomic_load(&sites[*(const int*)p].bytes);
+    unsigned long long r = atomic_load(&sites[*(const int*)q].bytes);
+    return (l < r) - (l > r);
+}
+
+static const char* lifetimeLabel(int bucket, char* out, size_t size) {
+    double ns = (double)(1ull << bucket);
+    if(ns < 1e3) {
+        snprintf(out, size, "%.0fns", ns);
+    }
+    else if(ns < 1e6) {
+        snprintf(out, size, "%.0fus", ns / 1e3);
+    }
+    else if(ns < 1e9) {
+        snprintf(out, size, "%.0fms", ns / 1e6);
+    }
+    else {
+        snprintf(out, size, "%.0fs", ns / 1e9);
+    }
+    return out;
+}
+
+static void printSite(FILE* out, int index) {
+    Site* site = &sites[index];
+    unsigned long long allocations = atomic_load(&site->allocations);
+    unsigned long long bytes = atomic_load(&site->bytes);
+    unsigned long long frees = atomic_load(&site->frees);
+    char name[512];
+    describeSite(atomic_load(&site->address), name, sizeof(name));
+    fprintf(out, "%12llu %14llu %10.1f %10llu %12llu %12.1f  %s\n", allocations, bytes,
+            allocations ? (double)bytes / allocations : 0.0, allocations - frees,
+            (unsigned long long)atomic_load(&site->liveBytes),
+            frees ? atomic_load(&site->lifetimeNs) / 1e3 / frees : 0.0, name);
+
+    unsigned long long peak = 0;
+    int first = LIFETIME_BUCKETS;
+    int last = -1;
+    for(int b = 0; b < LIFETIME_BUCKETS; ++b) {
+        unsigned long long n = atomic_load(&site->lifetimes[b]);
+        if(n > 0) {
+            peak = n > peak ? n : peak;
+            first = b < first ? b : first;
+            last = b;
+        }
+    }
+    for(int b = first; b <= last; ++b) {
+        unsigned long long n = atomic_load(&site->lifetimes[b]);
+        char label[16];
+        char bar[41];
+        int width = (int)(n * 40 / peak);
+        memset(bar, '#', width);
+        bar[width] = '\0';
+        fprintf(out, "%26s < %-6s %10llu  %s\n", "lifetime", lifetimeLabel(b + 1, label, sizeof(label)), n, bar);
+    }
+}
+
+__attribute__((destructor))
+static void reportAllocations(void) {
+    inTracker = 1;
+    atomic_store(&trackerDone, 1);
+
+    const char* topText = getenv("ALLOC_TRACK_TOP");
+    const char* path = getenv("ALLOC_TRACK_OUTPUT");
+    int top = topText != NULL && atoi(topText) > 0 ? atoi(topText) : DEFAULT_TOP;
+    FILE* out = path != NULL ? fopen(path, "w") : stderr;
+    if(out == NULL) {
+        out = stderr;
+    }
+
+    int used[MAX_SITES];
+    int count = 0;
+    unsigned long long totalAllocations = 0, totalBytes = 0;
+    for(int i = 0; i < MAX_SITES; ++i) {
+        unsigned long long n = atomic_load(&sites[i].allocations);
+        if(n > 0) {
+            used[count++] = i;
+            totalAllocations += n;
+            totalBytes += atomic_load(&sites[i].bytes);
+        }
+    }
+    fprintf(out, "\nallocations: %llu calls, %llu bytes from %d call sites\n", totalAllocations, totalBytes, count);
+    if(count == 0) {
+        if(out != stderr) {
+            fclose(out);
+        }
+        return;
+    }
+    fprintf(out, "%12s %14s %10s %10s %12s %12s  %s\n", "calls", "bytes", "avg size", "live", "live bytes",
+            "avg life us", "call site");
+
+    int shown = top < count ? top : count;
+    qsort(used, count, sizeof(int), compareByAllocations);
+    int listed[MAX_SITES];
+    int listedCount = 0;
+    fprintf(out, "top %d by calls:\n", shown);
+    for(int i = 0; i < shown; ++i) {
+        printSite(out, used[i]);
+        listed[listedCount++] = used[i];
+    }
+
+    qsort(used, count, sizeof(int), compareByBytes);
+    int header = 0;
+    for(int i = 0; i < shown; ++i) {
+        int already = 0;
+        for(int j = 0; j < listedCount; ++j) {
+            already |= listed[j] == used[i];
+        }
+        if(already) {
+            continue;
+        }
+        if(!header) {
+            fprintf(out, "also in the top %d by bytes:\n", shown);
+            header = 1;
+        }
+        printSite(out, used[i]);
+    }
+
+    if(out != stderr) {
+        fclose(out);
+    }
+}
@@ -0,0 +1,293 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/*
+   Opt-in tracing for hot paths. Compile with -DTRACE to turn it on; without it every macro below
+   expands to nothing, so the instrumented code is exactly the uninstrumented code.
+
+       void* my_malloc(size_t size) {
+           TRACE_FUNCTION();           // Times the rest of the block, however it is left
+           TRACE_BYTES(size);          // Bytes handled by this call
+           ...
+       }
+
+   - TRACE_FUNCTION() and TRACE_SCOPE("name") start a timer that stops when the enclosing block is
+     left, including through an early return (GCC/Clang cleanup attribute). One per block.
+   - TRACE_BYTES(n) adds n to the bytes of the innermost timer; it only touches a local variable, so it
+     can be used inside loops.
+   - Times are read from the CPU cycle counter (rdtsc on x86, cntvct_el0 on AArch64, CLOCK_MONOTONIC in
+     nanoseconds elsewhere) and converted to time at report time.
+   - Every thread updates only its own buffer: call, byte and cycle counters per site, a log2 histogram
+     of call durations, and a ring of its most recent calls. No lock or atomic read-modify-write is
+     taken on the hot path. Buffers are linked into a list with a compare-and-swap when a thread
+     first traces something, and are never freed, so the report still sees threads that have exited.
+   - The report is printed to stderr at exit, or whenever traceReport() is called. It merges the
+     buffers without stopping anyone, so it is meant for the end of a run or a quiet moment: counts
+     from threads still running may be a few calls behind and their latest ring entries half-written.
+   - The state is static, so each program (each translation unit) that includes this header traces
+     and reports its own sites.
+*/
+
+#if defined(TRACE)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define TRACE_MAX_SITES 64
+#define TRACE_BUCKETS 48            // Durations up to 2^48 cycles
+#define TRACE_RING 256              // Recent calls kept per thread
+#define TRACE_SLOWEST 10            // Recent calls listed in the report
+
+typedef struct {
+    const char* name;
+    atomic_int id;                  // Slot + 1; 0 until the site is first reached, -1 if there was no slot
+} TraceSite;
+
+typedef struct {
+    int site;
+    uint64_t start;
+    uint64_t cycles;
+    uint64_t bytes;
+} TraceEvent;
+
+typedef struct TraceThread {
+    struct TraceThread* next;
+    int number;
+    atomic_uint_fast64_t calls[TRACE_MAX_SITES];
+    atomic_uint_fast64_t bytes[TRACE_MAX_SITES];
+    atomic_uint_fast64_t cycles[TRACE_MAX_SITES];
+    atomic_uint_fast64_t maxCycles[TRACE_MAX_SITES];
+    atomic_uint_fast64_t histogram[TRACE_MAX_SITES][TRACE_BUCKETS];
+    TraceEvent ring[TRACE_RING];
+    atomic_size_t ringCount;
+} TraceThread;
+
+typedef struct {
+    int site;
+    uint64_t start;
+    uint64_t bytes;
+} TraceScope;
+
+static _Atomic(TraceSite*) traceSites[TRACE_MAX_SITES];
+static atomic_int traceSiteCount = 0;
+static _Atomic(TraceThread*) traceThreads = NULL;
+static atomic_int traceThreadCount = 0;
+static _Thread_local TraceThread* traceLocal = NULL;
+static uint64_t traceStartCycles;
+static struct timespec traceStartTime;
+
+static inline uint64_t traceCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000u + t.tv_nsec;
+#endif
+}
+
+static void traceReport(void);
+
+// Relaxed load and store: only the owning thread writes, so no read-modify-write is needed
+static inline void traceAdd(atomic_uint_fast64_t* counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value,
+                          memory_order_relaxed);
+}
+
+static int traceRegister(TraceSite* site) {
+    int expected = 0;
+    int id = atomic_fetch_add(&traceSiteCount, 1);
+    if(id >= TRACE_MAX_SITES) {
+        // Out of slots: mark the site so it isn't registered again, and don't record it
+        atomic_store(&site->id, -1);
+        return -1;
+    }
+    if(id == 0) {
+        // The first site registers the report and the reference point for converting cycles to time
+        traceStartCycles = traceCycles();
+        clock_gettime(CLOCK_MONOTONIC, &traceStartTime);
+        atexit(traceReport);
+    }
+    atomic_store(&traceSites[id], site);
+    // A thread that loses the race to register the same site uses the winner's slot
+    if(!atomic_compare_exchange_strong(&site->id, &expected, id + 1)) {
+        atomic_store(&traceSites[id], NULL);
+        return expected > 0 ? expected - 1 : -1;
+    }
+    return id;
+}
+
+static TraceThread* traceThread(void) {
+    if(traceLocal == NULL) {
+        TraceThread* t = calloc(1, sizeof(TraceThread));
+        if(t == NULL) {
+            printf("Memory allocation failed!!\n");
+            exit(1);
+        }
+        t->number = atomic_fetch_add(&traceThreadCount, 1) + 1;
+        t->next = atomic_load(&traceThreads);
+        while(!atomic_compare_exchange_weak(&traceThreads, &t->next, t)) {
+        }
+        traceLocal = t;
+    }
+    return traceLocal;
+}
+
+static inline TraceScope traceBegin(TraceSite* site) {
+    TraceScope scope;
+    int id = atomic_load_explicit(&site->id, memory_order_relaxed);
+    scope.site = id > 0 ? id - 1 : id < 0 ? -1 : traceRegister(site);
+    scope.bytes = 0;
+    scope.start = traceCycles();
+    return scope;
+}
+
+static inline void traceEnd(TraceScope* scope) {
+    uint64_t cycles = traceCycles() - scope->start;
+    if(scope->site < 0) {
+        return;
+    }
+    TraceThread* t = traceThread();
+    int site = scope->site;
+    int bucket = cycles ? 63 - __builtin_clzll(cycles) : 0;
+
+    traceAdd(&t->calls[site], 1);
+    traceAdd(&t->bytes[site], scope->bytes);
+    traceAdd(&t->cycles[site], cycles);
+    traceAdd(&t->histogram[site][bucket < TRACE_BUCKETS ? bucket : TRACE_BUCKETS - 1], 1);
+    if(cycles > atomic_load_explicit(&t->maxCycles[site], memory_order_relaxed)) {
+        atomic_store_explicit(&t->maxCycles[site], cycles, memory_order_relaxed);
+    }
+
+    size_t count = atomic_load_explicit(&t->ringCount, memory_order_relaxed);
+    TraceEvent* e = &t->ring[count % TRACE_RING];
+    e->site = site;
+    e->start = scope->start;
+    e->cycles = cycles;
+    e->bytes = scope->bytes;
+    atomic_store_explicit(&t->ringCount, count + 1, memory_order_release);
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#define TRACE_SCOPE(label)                                                                      \
+    static TraceSite TRACE_CONCAT(traceSite, __LINE__) = {label, 0};                            \
+    TraceScope traceScope __attribute__((cleanup(traceEnd))) = traceBegin(&TRACE_CONCAT(traceSite, __LINE__))
+#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+#define TRACE_BYTES(n) (traceScope.bytes += (uint64_t)(n))
+
+typedef struct {
+    int thread;
+    TraceEvent event;
+} TraceSlowCall;
+
+static int traceCompareSlow(const void* p, const void* q) {
+    uint64_t l = ((const TraceSlowCall*)p)->event.cycles;
+    uint64_t r = ((const TraceSlowCall*)q)->event.cycles;
+    return (l < r) - (l > r);
+}
+
+/*
+   - Per site: calls, bytes, total and mean time, the 99th percentile (the upper edge of the histogram
+     bucket it falls in, so within a factor of 2) and the maximum.
+   - Then the slowest of the calls still held in the per-thread rings, with the thread and the time
+     since tracing started, which is what points at the routine behind a latency spike.
+*/
+static void traceReport(void) {
+    int sites = atomic_load(&traceSiteCount);
+    if(sites > TRACE_MAX_SITES) {
+        sites = TRACE_MAX_SITES;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t elapsedCycles = traceCycles() - traceStartCycles;
+    double elapsedNs = (now.tv_sec - traceStartTime.tv_sec) * 1e9 + (now.tv_nsec - traceStartTime.tv_nsec);
+    double nsPerCycle = elapsedCycles > 0 ? elapsedNs / elapsedCycles : 1;
+
+    fprintf(stderr, "\ntrace: %d sites, %d threads, cycle counter at %.2f GHz\n",
+            sites, atomic_load(&traceThreadCount), 1 / nsPerCycle);
+    fprintf(stderr, "%-24s %12s %14s %12s %12s %12s %12s\n",
+            "site", "calls", "bytes", "total ms", "mean ns", "p99 ns <=", "max ns");
+
+    TraceSlowCall slowest[TRACE_SLOWEST];
+    int slowCount = 0;
+    for(int s = 0; s < sites; ++s) {
+        TraceSite* site = atomic_load(&traceSites[s]);
+        if(site == NULL) {
+            continue;
+        }
+        uint64_t calls = 0, bytes = 0, cycles = 0, maxCycles = 0;
+        uint64_t histogram[TRACE_BUCKETS] = {0};
+        for(TraceThread* t = atomic_load(&traceThreads); t != NULL; t = t->next) {
+            calls += atomic_load_explicit(&t->calls[s], memory_order_relaxed);
+            bytes += atomic_load_explicit(&t->bytes[s], memory_order_relaxed);
+            cycles += atomic_load_explicit(&t->cycles[s], memory_order_relaxed);
+            uint64_t m = atomic_load_explicit(&t->maxCycles[s], memory_order_relaxed);
+            maxCycles = m > maxCycles ? m : maxCycles;
+            for(int b = 0; b < TRACE_BUCKETS; ++b) {
+                histogram[b] += atomic_load_explicit(&t->histogram[s][b], memory_order_relaxed);
+            }
+        }
+        if(calls == 0) {
+            continue;
+        }
+        uint64_t seen = 0;
+        int p99 = 0;
+        while(p99 < TRACE_BUCKETS - 1 && (seen += histogram[p99]) * 100 < calls * 99) {
+            p99++;
+        }
+        fprintf(stderr, "%-24s %12llu %14llu %12.3f %12.1f %12.0f %12.0f\n", site->name,
+                (unsigned long long)calls, (unsigned long long)bytes, cycles * nsPerCycle / 1e6,
+                cycles * nsPerCycle / calls, (double)(2ull << p99) * nsPerCycle, maxCycles * nsPerCycle);
+    }
+
+    // Keep the TRACE_SLOWEST longest calls across every thread's ring
+    for(TraceThread* t = atomic_load(&traceThreads); t != NULL; t = t->next) {
+        size_t count = atomic_load_explicit(&t->ringCount, memory_order_acquire);
+        size_t first = count > TRACE_RING ? count - TRACE_RING : 0;
+        for(size_t i = first; i < count; ++i) {
+            TraceSlowCall call = {t->number, t->ring[i % TRACE_RING]};
+            if(slowCount < TRACE_SLOWEST) {
+                slowest[slowCount++] = call;
+                qsort(slowest, slowCount, sizeof(TraceSlowCall), traceCompareSlow);
+            }
+            else if(call.event.cycles > slowest[TRACE_SLOWEST - 1].event.cycles) {
+                slowest[TRACE_SLOWEST - 1] = call;
+                qsort(slowest, slowCount, sizeof(TraceSlowCall), traceCompareSlow);
+            }
+        }
+    }
+    if(slowCount > 0) {
+        fprintf(stderr, "slowest recent calls:\n");
+    }
+    for(int i = 0; i < slowCount; ++i) {
+        TraceSite* site = atomic_load(&traceSites[slowest[i].event.site]);
+        fprintf(stderr, "  %-24s thread %-3d %12.0f ns %12llu bytes  at %.3f ms\n",
+                site != NULL ? site->name : "?", slowest[i].thread, slowest[i].event.cycles * nsPerCycle,
+                (unsigned long long)slowest[i].event.bytes,
+                (double)(int64_t)(slowest[i].event.start - traceStartCycles) * nsPerCycle / 1e6);
+    }
+}
+
+#else
+
+#define TRACE_SCOPE(label)
+#define TRACE_FUNCTION()
+#define TRACE_BYTES(n) ((void)0)
+
+#endif
+
+#endif
@@ -1,6 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "../Instrumentation/Trace.h"
 
 typedef struct {
     void* data;             // Pointer to the array data
@@ -22,6 +28,8 @@ DynamicArray* init(size_t element_size, size_t capacity) {
 
 // Resize the Array
 void resize(DynamicArray* arr, size_t newCapacity) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(arr->element_size * newCapacity);
     void* new_data = realloc(arr->data, (arr->element_size) * newCapacity);
     if(new_data == NULL) {
         printf("Memory allocation failed!!\n");
@@ -33,6 +41,8 @@ void resize(DynamicArray* arr, size_t newCapacity) {
 
 // Add elements to the Array
 void addElement(DynamicArray* arr, void* element) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(arr->element_size);
     if(arr->noOfElements == arr->capacity) {
         resize(arr, (arr->capacity) * 2);
     }
@@ -59,7 +69,319 @@ void destroy(DynamicArray* arr) {
     free(arr);
 }
 
-int main() {
+/*
+   Parallel sort for raw arrays and Dynamic Arrays, with the same comparator as qsort.
+   - The array is cut into one run per thread and every thread sorts its own run.
+   - The runs are then merged in pairs, round after round, until one is left. In every round all the
+     threads keep working, even when only one pair is left: each pair's output is cut into equal
+     slices and every slice is merged by a different thread.
+   - A slice starts at the point of the output where the merge would be after k elements; that point
+     is found by binary search along the diagonal of the merge (the "merge path"), so the slices need
+     no coordination and together produce exactly the sequential merge.
+   - Merging always takes the element from the left run on ties, so it is stable. With 'stable' set,
+     the runs are sorted with a merge sort too (qsort is not guaranteed to be stable), and equal
+     elements keep their original order.
+   - A buffer as large as the array is used as the destination of every other round.
+*/
+typedef int (*Comparator)(const void*, const void*);
+
+#define PARALLEL_SORT_MIN 16384     // Fewest elements per thread; fewer threads are used below that
+#define INSERTION_RUN 16
+
+// Merge a[0, na) and b[0, nb) into dest, taking from a on ties
+static void mergeRuns(const char* a, size_t na, const char* b, size_t nb, char* dest, size_t size, Comparator compare) {
+    const char* aEnd = a + na * size;
+    const char* bEnd = b + nb * size;
+    while(a < aEnd && b < bEnd) {
+        if(compare(a, b) <= 0) {
+            memcpy(dest, a, size);
+            a += size;
+        }
+        else {
+            memcpy(dest, b, size);
+            b += size;
+        }
+        dest += size;
+    }
+    memcpy(dest, a, aEnd - a);
+    dest += aEnd - a;
+    memcpy(dest, b, bEnd - b);
+}
+
+// How many of the first 'diagonal' merged elements come from a
+static size_t mergePath(const char* a, size_t na, const char* b, size_t nb, size_t diagonal, size_t size, Comparator compare) {
+    size_t lo = diagonal > nb ? diagonal - nb : 0;
+    size_t hi = diagonal < na ? diagonal : na;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if(compare(a + mid * size, b + (diagonal - mid - 1) * size) <= 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Stable merge sort of base[0, n), using buffer (n elements) as scratch space
+static void mergeSort(char* base, size_t n, size_t size, Comparator compare, char* buffer) {
+    // Insertion sort short runs first; it only moves an element past strictly greater ones
+    char* value = buffer;
+    for(size_t start = 0; start < n; start += INSERTION_RUN) {
+        size_t end = start + INSERTION_RUN < n ? start + INSERTION_RUN : n;
+        for(size_t i = start + 1; i < end; ++i) {
+            size_t j = i;
+            while(j > start && compare(base + (j - 1) * size, base + i * size) > 0) {
+                j--;
+            }
+            if(j != i) {
+                memcpy(value, base + i * size, size);
+                memmove(base + (j + 1) * size, base + j * size, (i - j) * size);
+                memcpy(base + j * size, value, size);
+            }
+        }
+    }
+
+    char* src = base;
+    char* dest = buffer;
+    for(size_t width = INSERTION_RUN; width < n; width *= 2) {
+        for(size_t start = 0; start < n; start += 2 * width) {
+            size_t mid = start + width < n ? start + width : n;
+            size_t end = start + 2 * width < n ? start + 2 * width : n;
+            mergeRuns(src + start * size, mid - start, src + mid * size, end - mid, dest + start * size, size, compare);
+        }
+        char* temp = src;
+        src = dest;
+        dest = temp;
+    }
+    if(src != base) {
+        memcpy(base, src, n * size);
+    }
+}
+
+typedef struct {
+    char* src;
+    char* dest;
+    size_t size;
+    Comparator compare;
+    int stable;
+    const size_t* bounds;       // Run i is [bounds[i], bounds[i + 1])
+    size_t runs;
+    size_t slices;              // Threads per pair of runs in the merge rounds
+    int threads;
+    int id;
+} SortTask;
+
+static void* sortRunWorker(void* arg) {
+    SortTask* task = arg;
+    size_t start = task->bounds[task->id];
+    size_t n = task->bounds[task->id + 1] - start;
+    if(task->stable) {
+        mergeSort(task->src + start * task->size, n, task->size, task->compare, task->dest + start * task->size);
+    }
+    else {
+        qsort(task->src + start * task->size, n, task->size, task->compare);
+    }
+    return NULL;
+}
+
+// Merge every pair of runs, slice by slice; a run without a partner is copied across
+static void* mergeWorker(void* arg) {
+    SortTask* task = arg;
+    size_t size = task->size;
+    size_t pairs = (task->runs + 1) / 2;
+    for(size_t job = task->id; job < pairs * task->slices; job += task->threads) {
+        size_t pair = job / task->slices;
+        size_t slice = job % task->slices;
+        size_t start = task->bounds[2 * pair];
+        size_t mid = task->bounds[2 * pair + 1];
+        size_t end = 2 * pair + 2 <= task->runs ? task->bounds[2 * pair + 2] : mid;
+        const char* a = task->src + start * size;
+        const char* b = task->src + mid * size;
+        size_t na = mid - start;
+        size_t nb = end - mid;
+
+        size_t from = (na + nb) * slice / task->slices;
+        size_t to = (na + nb) * (slice + 1) / task->slices;
+        size_t aFrom = mergePath(a, na, b, nb, from, size, task->compare);
+        size_t aTo = mergePath(a, na, b, nb, to, size, task->compare);
+        mergeRuns(a + aFrom * size, aTo - aFrom, b + (from - aFrom) * size, (to - aTo) - (from - aFrom),
+                  task->dest + (start + from) * size, size, task->compare);
+    }
+    return NULL;
+}
+
+static void runWorkers(SortTask* tasks, int threads, void* (*worker)(void*)) {
+    pthread_t* ids = malloc(threads * sizeof(pthread_t));
+    if(ids == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    for(int i = 1; i < threads; ++i) {
+        if(pthread_create(&ids[i], NULL, worker, &tasks[i]) != 0) {
+            printf("Thread creation failed!!\n");
+            exit(1);
+        }
+    }
+    // The calling thread does its own share
+    worker(&tasks[0]);
+    for(int i = 1; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+    }
+    free(ids);
+}
+
+// Sort n elements of 'size' bytes; threads <= 0 uses every online CPU
+void parallelSort(void* base, size_t n, size_t size, Comparator compare, int threads, int stable) {
+    if(n < 2) {
+        return;
+    }
+    if(threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if((size_t)threads > n / PARALLEL_SORT_MIN) {
+        threads = (int)(n / PARALLEL_SORT_MIN);
+    }
+    if(threads <= 1 && !stable) {
+        qsort(base, n, size, compare);
+        return;
+    }
+    if(threads < 1) {
+        threads = 1;
+    }
+
+    char* buffer = malloc(n * size);
+    size_t* bounds = malloc((threads + 1) * sizeof(size_t));
+    SortTask* tasks = malloc(threads * sizeof(SortTask));
+    if(buffer == NULL || bounds == NULL || tasks == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    for(int i = 0; i <= threads; ++i) {
+        bounds[i] = n * i / threads;
+    }
+
+    char* src = base;
+    char* dest = buffer;
+    for(int i = 0; i < threads; ++i) {
+        tasks[i] = (SortTask){src, dest, size, compare, stable, bounds, (size_t)threads, 1, threads, i};
+    }
+    runWorkers(tasks, threads, sortRunWorker);
+
+    // Merge rounds: the runs halve every round, and the threads spread over the pairs that are left
+    size_t runs = threads;
+    while(runs > 1) {
+        size_t pairs = (runs + 1) / 2;
+        size_t slices = (threads + pairs - 1) / pairs;
+        for(int i = 0; i < threads; ++i) {
+            tasks[i] = (SortTask){src, dest, size, compare, stable, bounds, runs, slices, threads, i};
+        }
+        runWorkers(tasks, threads, mergeWorker);
+
+        // Pair i of this round is run i of the next
+        for(size_t i = 0; 2 * i < runs; ++i) {
+            bounds[i] = bounds[2 * i];
+        }
+        bounds[pairs] = n;
+        runs = pairs;
+
+        char* temp = src;
+        src = dest;
+        dest = temp;
+    }
+
+    if(src != base) {
+        memcpy(base, src, n * size);
+    }
+    free(tasks);
+    free(bounds);
+    free(buffer);
+}
+
+// Sort the elements of a Dynamic Array in place
+void sortArray(DynamicArray* arr, Comparator compare, int threads, int stable) {
+    parallelSort(arr->data, arr->noOfElements, arr->element_size, compare, threads, stable);
+}
+
+/*
+   Benchmark: ./DynamicArrayLibrary bench [elements] [threads]
+   - Sorts 16-byte records by key with qsort and with parallelSort, unstable and stable, and checks
+     that the stable result keeps equal keys in their original order.
+*/
+typedef struct {
+    uint64_t key;
+    uint64_t id;                // Original position, to check stability
+} Record;
+
+static int compareRecords(const void* a, const void* b) {
+    uint64_t x = ((const Record*)a)->key;
+    uint64_t y = ((const Record*)b)->key;
+    return (x > y) - (x < y);
+}
+
+static double elapsedMs(struct timespec begin, struct timespec end) {
+    return (end.tv_sec - begin.tv_sec) * 1e3 + (end.tv_nsec - begin.tv_nsec) / 1e6;
+}
+
+static int runBenchmark(size_t n, int threads) {
+    Record* input = malloc(n * sizeof(Record));
+    Record* work = malloc(n * sizeof(Record));
+    if(input == NULL || work == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    uint64_t state = 88172645463325252ull;
+    for(size_t i = 0; i < n; ++i) {
+        // xorshift64; keys repeat often so stability is visible
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        input[i].key = state % (n / 4 + 1);
+        input[i].id = i;
+    }
+
+    const char* labels[] = {"qsort", "parallelSort", "parallelSort stable"};
+    for(int mode = 0; mode < 3; ++mode) {
+        memcpy(work, input, n * sizeof(Record));
+        struct timespec begin, end;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        if(mode == 0) {
+            qsort(work, n, sizeof(Record), compareRecords);
+        }
+        else {
+            parallelSort(work, n, sizeof(Record), compareRecords, threads, mode == 2);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        int sorted = 1;
+        int stable = 1;
+        for(size_t i = 1; i < n; ++i) {
+            sorted &= work[i - 1].key <= work[i].key;
+            stable &= work[i - 1].key != work[i].key || work[i - 1].id < work[i].id;
+        }
+        printf("%-20s %10zu records %10.1fms  %s%s\n", labels[mode], n, elapsedMs(begin, end),
+               sorted ? "sorted" : "NOT SORTED", stable ? ", stable" : "");
+    }
+
+    free(input);
+    free(work);
+    return 0;
+}
+
+static int compareIntsDescending(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x < y) - (x > y);
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        size_t n = argc > 2 ? strtoull(argv[2], NULL, 10) : 10000000;
+        int threads = argc > 3 ? atoi(argv[3]) : 0;
+        return runBenchmark(n, threads);
+    }
 
     // Initialize a Dynamic array for integers
     DynamicArray *arr = init(sizeof(int), 4);
@@ -86,6 +408,14 @@ int main() {
     }
     printf("\n");
 
+    // Sort the elements in descending order
+    sortArray(arr, compareIntsDescending, 0, 1);
+    printf("Array elements sorted in descending order: ");
+    for(size_t i=0; i<arr->noOfElements; ++i) {
+        printf("%d ", ((int*)arr->data)[i]);
+    }
+    printf("\n");
+
     // Destroy the Array
     destroy(arr);
 
@@ -0,0 +1,436 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+/*
+   A generic hash map: keys and values of any fixed size, copied in by bytes, just like the elements of
+   DynamicArray. Keys are compared with memcmp, so a key type must not contain padding bytes with
+   undefined contents (zero the struct first, or use fixed-size char arrays).
+   - Open addressing with linear probing: all entries live in one flat array, and a lookup checks
+     consecutive slots, which keeps it to one or two cache lines.
+   - Every slot has a control byte: 0 for empty, or 0x80 plus 7 bits of the key's hash. A lookup only
+     calls memcmp on slots whose control byte matches, so a miss rarely touches the keys at all.
+   - The value of an entry starts at the key size rounded up to the value's alignment, and entries are
+     padded to a multiple of it, so the pointer mapGet returns can be dereferenced as the value type
+     whatever the key size (a 7-byte key with an int value, say).
+   - Removing an entry shifts the entries after it back into the hole, so there are no tombstones and
+     lookups never slow down after many removals.
+   - Growing is incremental: instead of rehashing every entry at once, the old array is kept next to the
+     new one and every insert or removal moves a few of its slots across, so no single insert ever
+     pauses for a full rehash.
+*/
+#define MAP_EMPTY 0
+#define MAP_DELETED 1           // Only in the old array while it is being drained
+#define MAP_MIGRATE_STEP 16     // Old slots moved per operation while growing
+
+typedef struct {
+    unsigned char* control;     // One control byte per slot
+    char* slots;                // capacity entries of entry_size bytes
+    size_t capacity;            // Always a power of two
+    size_t count;
+} HashTable;
+
+typedef struct {
+    size_t key_size;            // Size of each key
+    size_t value_size;          // Size of each value
+    size_t value_offset;        // Where the value starts in an entry: key_size rounded up to its alignment
+    size_t entry_size;          // value_offset + value_size, rounded up so every entry's value is aligned
+    HashTable table;            // Where new entries go
+    HashTable old;              // The previous array while it is being drained, capacity 0 otherwise
+    size_t migrated;            // Slots of old already moved into table
+    size_t noOfElements;        // Number of entries in the map
+} HashMap;
+
+/*
+   - The hash reads the key 8 bytes at a time, mixing each word in with a multiply and a shift, and
+     finishes with the splitmix64 finalizer so every input bit affects the low bits used as the index.
+*/
+static uint64_t hashBytes(const void* key, size_t length) {
+    const unsigned char* p = key;
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ length;
+    while(length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+        p += 8;
+        length -= 8;
+    }
+    if(length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, p, length);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+    }
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+static unsigned char hashTag(uint64_t hash) {
+    return (unsigned char)(0x80 | (hash >> 57));
+}
+
+static void initTable(HashTable* table, size_t capacity, size_t entry_size) {
+    table->control = calloc(capacity, 1);
+    table->slots = malloc(capacity * entry_size);
+    if(table->control == NULL || table->slots == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    table->capacity = capacity;
+    table->count = 0;
+}
+
+static void freeTable(HashTable* table) {
+    free(table->control);
+    free(table->slots);
+    table->control = NULL;
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+// Slot holding key, or -1
+static long findSlot(const HashMap* map, const HashTable* table, const void* key, uint64_t hash) {
+    if(table->capacity == 0) {
+        return -1;
+    }
+    size_t mask = table->capacity - 1;
+    unsigned char tag = hashTag(hash);
+    for(size_t i = hash & mask;; i = (i + 1) & mask) {
+        unsigned char c = table->control[i];
+        if(c == MAP_EMPTY) {
+            return -1;
+        }
+        if(c == tag && memcmp(table->slots + i * map->entry_size, key, map->key_size) == 0) {
+            return (long)i;
+        }
+    }
+}
+
+// Claim the first free slot for a key known not to be in the table; the caller fills it in
+static char* claimSlot(const HashMap* map, HashTable* table, uint64_t hash) {
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while(table->control[i] != MAP_EMPTY) {
+        i = (i + 1) & mask;
+    }
+    table->control[i] = hashTag(hash);
+    table->count++;
+    return table->slots + i * map->entry_size;
+}
+
+// Move a few slots of the old array across; free it once it is empty
+static void migrateStep(HashMap* map) {
+    if(map->old.capacity == 0) {
+        return;
+    }
+    for(int step = 0; step < MAP_MIGRATE_STEP && map->migrated < map->old.capacity; ++step) {
+        size_t i = map->migrated++;
+        if(map->old.control[i] >= 0x80) {
+            const char* entry = map->old.slots + i * map->entry_size;
+            memcpy(claimSlot(map, &map->table, hashBytes(entry, map->key_size)), entry, map->entry_size);
+            map->old.control[i] = MAP_DELETED;
+            map->old.count--;
+        }
+    }
+    if(map->old.count == 0 || map->migrated == map->old.capacity) {
+        freeTable(&map->old);
+    }
+}
+
+// Start growing when the table is 3/4 full; linear probing gets slow beyond that
+static void growIfNeeded(HashMap* map) {
+    if((map->table.count + 1) * 4 <= map->table.capacity * 3) {
+        return;
+    }
+    // The previous growth can't still be running at this point, but finish it if it is
+    while(map->old.capacity != 0) {
+        migrateStep(map);
+    }
+    map->old = map->table;
+    map->migrated = 0;
+    initTable(&map->table, map->old.capacity * 2, map->entry_size);
+}
+
+// Initialize the Hash Map
+HashMap* initMap(size_t key_size, size_t value_size, size_t capacity) {
+    HashMap* map = (HashMap*)malloc(sizeof(HashMap));
+    if(map == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    map->key_size = key_size;
+    map->value_size = value_size;
+
+    // A type's alignment divides its size, so the largest power of two dividing value_size (up to what
+    // malloc guarantees) is enough for whatever type the caller stores there
+    size_t align = value_size & -value_size;
+    if(align == 0 || align > _Alignof(max_align_t)) {
+        align = value_size == 0 ? 1 : _Alignof(max_align_t);
+    }
+    map->value_offset = (key_size + align - 1) / align * align;
+    map->entry_size = (map->value_offset + value_size + align - 1) / align * align;
+
+    // Room for 'capacity' entries below the 3/4 load limit, rounded up to a power of two
+    size_t slots = 16;
+    while(slots * 3 < capacity * 4) {
+        slots *= 2;
+    }
+    initTable(&map->table, slots, map->entry_size);
+    map->old.control = NULL;
+    map->old.slots = NULL;
+    map->old.capacity = 0;
+    map->old.count = 0;
+    map->migrated = 0;
+    map->noOfElements = 0;
+    return map;
+}
+
+/*
+   - Returns a pointer to the value stored for key, or NULL. The pointer is valid until the next
+     mapPut or mapRemove, which may move entries.
+   - Lookups never move entries: only mapPut and mapRemove advance an incremental growth, so pointers
+     from several mapGet calls can be held at the same time.
+*/
+void* mapGet(HashMap* map, const void* key) {
+    uint64_t hash = hashBytes(key, map->key_size);
+    long i = findSlot(map, &map->table, key, hash);
+    if(i >= 0) {
+        return map->table.slots + i * map->entry_size + map->value_offset;
+    }
+    i = findSlot(map, &map->old, key, hash);
+    if(i >= 0) {
+        return map->old.slots + i * map->entry_size + map->value_offset;
+    }
+    return NULL;
+}
+
+// Insert or replace the value for key
+void mapPut(HashMap* map, const void* key, const void* value) {
+    migrateStep(map);
+    growIfNeeded(map);
+    uint64_t hash = hashBytes(key, map->key_size);
+
+    long i = findSlot(map, &map->table, key, hash);
+    if(i >= 0) {
+        memcpy(map->table.slots + i * map->entry_size + map->value_offset, value, map->value_size);
+        return;
+    }
+
+    // A key still in the old array is moved across now, with its new value
+    i = findSlot(map, &map->old, key, hash);
+    if(i >= 0) {
+        map->old.control[i] = MAP_DELETED;
+        map->old.count--;
+    }
+    else {
+        map->noOfElements++;
+    }
+    char* slot = claimSlot(map, &map->table, hash);
+    memcpy(slot, key, map->key_size);
+    memcpy(slot + map->value_offset, value, map->value_size);
+}
+
+// Remove key from the map; returns 0 if it was not there
+int mapRemove(HashMap* map, const void* key) {
+    migrateStep(map);
+    uint64_t hash = hashBytes(key, map->key_size);
+
+    // The old array is only drained, never probed for free slots, so a tombstone is enough there
+    long found = findSlot(map, &map->old, key, hash);
+    if(found >= 0) {
+        map->old.control[found] = MAP_DELETED;
+        map->old.count--;
+        map->noOfElements--;
+        return 1;
+    }
+
+    found = findSlot(map, &map->table, key, hash);
+    if(found < 0) {
+        return 0;
+    }
+
+    // Shift later entries of the same probe run back into the hole
+    HashTable* table = &map->table;
+    size_t mask = table->capacity - 1;
+    size_t hole = (size_t)found;
+    for(size_t j = (hole + 1) & mask; table->control[j] != MAP_EMPTY; j = (j + 1) & mask) {
+        char* entry = table->slots + j * map->entry_size;
+        size_t home = hashBytes(entry, map->key_size) & mask;
+        // Entry j may move to the hole only if the hole is not before its home slot
+        if(((j - home) & mask) >= ((j - hole) & mask)) {
+            memcpy(table->slots + hole * map->entry_size, entry, map->entry_size);
+            table->control[hole] = table->control[j];
+            hole = j;
+        }
+    }
+    table->control[hole] = MAP_EMPTY;
+    table->count--;
+    map->noOfElements--;
+    return 1;
+}
+
+// Destroy the Hash Map
+void destroyMap(HashMap* map) {
+    freeTable(&map->table);
+    freeTable(&map->old);
+    free(map);
+}
+
+/*
+   Benchmark: ./HashMapLibrary bench [entries]
+   - Inserts, looks up and removes 'entries' 8-byte keys with 8-byte values, and reports the average and
+     the slowest single insert. With incremental growth no insert rehashes the whole map; what is left
+     in the slowest ones is mostly the allocator returning the drained array to the system.
+*/
+static double elapsedNs(struct timespec begin, struct timespec end) {
+    return (end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec);
+}
+
+static int runBenchmark(size_t n) {
+    HashMap* map = initMap(sizeof(uint64_t), sizeof(uint64_t), 16);
+    struct timespec begin, end, opBegin, opEnd;
+    double slowest = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for(uint64_t i = 0; i < n; ++i) {
+        uint64_t key = i * 0x9E3779B97F4A7C15ull;
+        clock_gettime(CLOCK_MONOTONIC, &opBegin);
+        mapPut(map, &key, &i);
+        clock_gettime(CLOCK_MONOTONIC, &opEnd);
+        double ns = elapsedNs(opBegin, opEnd);
+        if(ns > slowest) {
+            slowest = ns;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("mapPut    %10zu entries %8.1fns/op, slowest %.1fus\n", n, elapsedNs(begin, end) / n, slowest / 1e3);
+
+    size_t found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for(uint64_t i = 0; i < 2 * n; ++i) {
+        uint64_t key = i * 0x9E3779B97F4A7C15ull;
+        uint64_t* value = mapGet(map, &key);
+        found += value != NULL && *value == i;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("mapGet    %10zu lookups %8.1fns/op, %zu hits\n", 2 * n, elapsedNs(begin, end) / (2 * n), found);
+
+    size_t removed = 0;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for(uint64_t i = 0; i < n; ++i) {
+        uint64_t key = i * 0x9E3779B97F4A7C15ull;
+        removed += mapRemove(map, &key);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("mapRemove %10zu entries %8.1fns/op, %zu removed, %zu left\n", n, elapsedNs(begin, end) / n,
+           removed, map->noOfElements);
+
+    destroyMap(map);
+    return 0;
+}
+
+/*
+   Check: ./HashMapLibrary check
+   - Grows a map until it is in the middle of an incremental growth, takes a pointer to a value that is
+     still in the old array, looks up other keys, and then writes through the first pointer. Lookups
+     must not move entries, so the write has to land in the map (run it under AddressSanitizer to see
+     any stale pointer).
+   - Stores doubles behind 7-byte keys and checks every value pointer is aligned for a double.
+*/
+static int runCheck(void) {
+    HashMap* map = initMap(sizeof(uint64_t), sizeof(uint64_t), 0);
+    uint64_t key = 0;
+    // Past the first growth, so the old array has more slots than one migration step moves
+    while(map->old.capacity <= MAP_MIGRATE_STEP) {
+        uint64_t value = key * 10;
+        mapPut(map, &key, &value);
+        key++;
+    }
+    uint64_t inserted = key;
+
+    // A key in the last slots of the old array, which the next migration steps haven't reached
+    uint64_t held = inserted;
+    for(uint64_t k = 0; k < inserted; ++k) {
+        long slot = findSlot(map, &map->old, &k, hashBytes(&k, map->key_size));
+        if(slot >= 0 && (size_t)slot >= map->migrated + MAP_MIGRATE_STEP) {
+            held = k;
+        }
+    }
+    if(held == inserted) {
+        printf("check: no entry left in the old array\n");
+        destroyMap(map);
+        return 1;
+    }
+
+    uint64_t* value = mapGet(map, &held);
+    for(uint64_t k = 0; k < inserted; ++k) {
+        mapGet(map, &k);
+    }
+    *value = 12345;
+
+    uint64_t* again = mapGet(map, &held);
+    int ok = again == value && *again == 12345;
+    printf("check: value pointer %s across lookups during growth\n", ok ? "stays valid" : "was moved");
+    destroyMap(map);
+
+    // Values stay aligned when the key size isn't a multiple of their alignment
+    HashMap* odd = initMap(7, sizeof(double), 0);
+    int aligned = 1;
+    for(int i = 0; i < 100; ++i) {
+        char oddKey[7] = {0};
+        memcpy(oddKey, &i, sizeof(i));
+        double d = i * 0.5;
+        mapPut(odd, oddKey, &d);
+        double* stored = mapGet(odd, oddKey);
+        aligned &= (uintptr_t)stored % _Alignof(double) == 0 && *stored == d;
+    }
+    printf("check: values behind 7-byte keys are %s\n", aligned ? "aligned" : "misaligned");
+    destroyMap(odd);
+    return ok && aligned ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark(argc > 2 ? strtoull(argv[2], NULL, 10) : 1000000);
+    }
+    if(argc > 1 && strcmp(argv[1], "check") == 0) {
+        return runCheck();
+    }
+
+    // Map product codes (fixed-size strings) to stock counts
+    HashMap* stock = initMap(8, sizeof(int), 4);
+    const char* codes[] = {"apple", "banana", "cherry", "date", "elder", "fig", "grape"};
+    for(int i = 0; i < 7; ++i) {
+        char key[8] = {0};
+        strncpy(key, codes[i], sizeof(key) - 1);
+        int count = (i + 1) * 10;
+        mapPut(stock, key, &count);
+    }
+
+    char key[8] = "cherry";
+    int* count = mapGet(stock, key);
+    printf("cherry: %d\n", count ? *count : -1);
+
+    // Replace a value, then remove an entry
+    int updated = 99;
+    mapPut(stock, key, &updated);
+    printf("cherry after update: %d\n", *(int*)mapGet(stock, key));
+
+    char removedKey[8] = "banana";
+    mapRemove(stock, removedKey);
+    printf("banana after removal: %s\n", mapGet(stock, removedKey) ? "present" : "absent");
+    printf("Entries: %zu\n", stock->noOfElements);
+
+    destroyMap(stock);
+
+    return 0;
+}
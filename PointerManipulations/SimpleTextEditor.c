@@ -1,66 +1,1316 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../Instrumentation/Trace.h"
+
+/*
+   Gap buffer: the text is kept in one array with a hole (the gap) at the cursor.
+
+       data:  [ text before the cursor | ...gap... | text after the cursor ]
+               0                gapStart       gapEnd               capacity
+
+   - Inserting at the cursor writes into the gap, and deleting at the cursor widens the gap, so neither
+     has to shift the rest of the text: both cost O(1) apart from the bytes inserted.
+   - Editing somewhere else first moves the gap there, which moves only the bytes between the old and
+     the new position: O(distance), and nearby edits are cheap.
+   - The length is capacity minus the gap size, so it is never recomputed with strlen.
+   - When the gap is used up, the array grows by doubling and the gap grows with it, so inserts are
+     O(1) amortized just like DynamicArray's addElement.
+*/
+typedef struct {
+    char* data;         // Text before the gap, the gap, then text after the gap
+    size_t capacity;    // Total size of data
+    size_t gapStart;    // Index of the first byte of the gap, which is also the cursor position
+    size_t gapEnd;      // Index of the first byte after the gap
+    size_t* lineTree;   // Fenwick tree of newline counts per LINE_BLOCK bytes of data, see below
+    size_t lineBlocks;  // Number of blocks covered by lineTree
+    struct SearchIndex* searchIndex;    // Optional, see enableSearchIndex
+} GapBuffer;
+
+// Number of characters in the text
+size_t textLength(const GapBuffer* buf) {
+    return buf->capacity - (buf->gapEnd - buf->gapStart);
+}
+
+/*
+   Line index: answers "which line and column is this offset?" and "where does line N start?" in
+   O(log n) instead of rescanning the text.
+   - The data array is divided into blocks of LINE_BLOCK bytes, and a Fenwick tree (binary indexed tree)
+     holds the number of '\n' bytes in each block. It gives the newlines in any prefix of blocks, and
+     the block holding the k-th newline, in O(log n).
+   - It counts by physical index in data, gap included: the tree always matches the bytes actually in
+     the array. Deleting only widens the gap and changes no bytes, so it needs no update at all;
+     inserting and moving the gap update the blocks whose bytes they overwrite. Newlines left over in
+     the gap are subtracted at query time.
+*/
+#define LINE_BLOCK 64
+
+static void lineTreeAdd(GapBuffer* buf, size_t block, long delta) {
+    for(size_t i = block + 1; i <= buf->lineBlocks; i += i & (0 - i)) {
+        buf->lineTree[i - 1] += delta;
+    }
+}
+
+// Newlines in blocks [0, blocks)
+static size_t lineTreePrefix(const GapBuffer* buf, size_t blocks) {
+    size_t sum = 0;
+    for(size_t i = blocks; i > 0; i -= i & (0 - i)) {
+        sum += buf->lineTree[i - 1];
+    }
+    return sum;
+}
+
+// Recount every block, after the array was reallocated or rebuilt
+static void rebuildLineIndex(GapBuffer* buf) {
+    size_t blocks = (buf->capacity + LINE_BLOCK - 1) / LINE_BLOCK;
+    size_t* tree = realloc(buf->lineTree, (blocks + 1) * sizeof(size_t));
+    if(tree == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    buf->lineTree = tree;
+    buf->lineBlocks = blocks;
+    memset(tree, 0, blocks * sizeof(size_t));
+
+    for(size_t i = 0; i < buf->capacity; ++i) {
+        tree[i / LINE_BLOCK] += buf->data[i] == '\n';
+    }
+    // Turn the per-block counts into a Fenwick tree in O(n)
+    for(size_t i = 1; i <= blocks; ++i) {
+        size_t parent = i + (i & (0 - i));
+        if(parent <= blocks) {
+            tree[parent - 1] += tree[i - 1];
+        }
+    }
+}
+
+// Newlines in data[0, index)
+static size_t physicalNewlines(const GapBuffer* buf, size_t index) {
+    size_t block = index / LINE_BLOCK;
+    size_t count = lineTreePrefix(buf, block);
+    for(size_t i = block * LINE_BLOCK; i < index; ++i) {
+        count += buf->data[i] == '\n';
+    }
+    return count;
+}
+
+// Physical index of the k-th newline in data (k >= 1, counting gap bytes too)
+static size_t physicalFind(const GapBuffer* buf, size_t k) {
+    size_t block = 0;
+    size_t step = 1;
+    while(step * 2 <= buf->lineBlocks) {
+        step *= 2;
+    }
+    // Fenwick descent: the largest block prefix with fewer than k newlines
+    for(; step > 0; step /= 2) {
+        if(block + step <= buf->lineBlocks && buf->lineTree[block + step - 1] < k) {
+            block += step;
+            k -= buf->lineTree[block - 1];
+        }
+    }
+    size_t i = block * LINE_BLOCK;
+    for(;; ++i) {
+        if(buf->data[i] == '\n' && --k == 0) {
+            return i;
+        }
+    }
+}
+
+// Overwrite data[dest, dest + count) with src, keeping the line index in step; src may overlap data
+static void storeBytes(GapBuffer* buf, size_t dest, const char* src, size_t count) {
+    long delta = 0;
+    size_t block = dest / LINE_BLOCK;
+    for(size_t i = 0; i < count; ++i) {
+        if((dest + i) / LINE_BLOCK != block) {
+            if(delta != 0) {
+                lineTreeAdd(buf, block, delta);
+            }
+            block = (dest + i) / LINE_BLOCK;
+            delta = 0;
+        }
+        delta += (src[i] == '\n') - (buf->data[dest + i] == '\n');
+    }
+    if(delta != 0) {
+        lineTreeAdd(buf, block, delta);
+    }
+    memmove(buf->data + dest, src, count);
+}
+
+/*
+   Search index: an optional trigram index that makes repeated searches cost time proportional to the
+   query and its hits instead of the whole text.
+   - Every 3-byte sequence of the text (a trigram) is hashed into one of INDEX_BUCKETS posting lists,
+     which hold the positions where such trigrams start. A search looks up the word's rarest trigram
+     and checks only the positions listed there.
+   - Like the line index, positions are physical indexes into data, so an edit updates only the
+     trigrams touching the bytes it writes or moves, never the positions of the rest of the text.
+   - Only trigrams lying entirely on one side of the gap are indexed; the at most two that straddle it
+     are checked directly at search time.
+   - slot[p] records where position p sits in its posting list, so removing it is O(1).
+*/
+#define INDEX_BITS 16
+#define INDEX_BUCKETS (1 << INDEX_BITS)
+#define NOT_INDEXED ((size_t)-1)
+
+typedef struct {
+    size_t* positions;
+    size_t count;
+    size_t capacity;
+} Posting;
+
+typedef struct SearchIndex {
+    Posting buckets[INDEX_BUCKETS];
+    size_t* slot;               // One entry per byte of data, NOT_INDEXED if no trigram starts there
+} SearchIndex;
+
+static size_t trigramBucket(const char* bytes) {
+    unsigned key = (unsigned char)bytes[0] | (unsigned char)bytes[1] << 8 | (unsigned)(unsigned char)bytes[2] << 16;
+    return (key * 2654435761u) >> (32 - INDEX_BITS);
+}
+
+static int isText(const GapBuffer* buf, size_t index) {
+    return index < buf->gapStart || (index >= buf->gapEnd && index < buf->capacity);
+}
+
+// Add the trigrams starting in data[from, to) that lie entirely in the text
+static void indexRange(GapBuffer* buf, size_t from, size_t to) {
+    SearchIndex* index = buf->searchIndex;
+    if(index == NULL) {
+        return;
+    }
+    from = from >= 2 ? from - 2 : 0;
+    for(size_t p = from; p < to && p + 2 < buf->capacity; ++p) {
+        if(index->slot[p] != NOT_INDEXED || !isText(buf, p) || !isText(buf, p + 1) || !isText(buf, p + 2)) {
+            continue;
+        }
+        Posting* list = &index->buckets[trigramBucket(buf->data + p)];
+        if(list->count == list->capacity) {
+            size_t newCapacity = list->capacity ? list->capacity * 2 : 4;
+            size_t* newPositions = realloc(list->positions, newCapacity * sizeof(size_t));
+            if(newPositions == NULL) {
+                printf("Memory allocation failed!!\n");
+                exit(1);
+            }
+            list->positions = newPositions;
+            list->capacity = newCapacity;
+        }
+        index->slot[p] = list->count;
+        list->positions[list->count++] = p;
+    }
+}
+
+// Remove the trigrams that include any byte of data[from, to); call before the bytes change
+static void unindexRange(GapBuffer* buf, size_t from, size_t to) {
+    SearchIndex* index = buf->searchIndex;
+    if(index == NULL) {
+        return;
+    }
+    from = from >= 2 ? from - 2 : 0;
+    for(size_t p = from; p < to && p < buf->capacity; ++p) {
+        if(index->slot[p] == NOT_INDEXED) {
+            continue;
+        }
+        // Move the last entry of the list into the hole
+        Posting* list = &index->buckets[trigramBucket(buf->data + p)];
+        size_t last = list->positions[--list->count];
+        list->positions[index->slot[p]] = last;
+        index->slot[last] = index->slot[p];
+        index->slot[p] = NOT_INDEXED;
+    }
+}
+
+// Index the whole array again, after it was reallocated or rebuilt
+static void rebuildSearchIndex(GapBuffer* buf) {
+    SearchIndex* index = buf->searchIndex;
+    if(index == NULL) {
+        return;
+    }
+    for(size_t i = 0; i < INDEX_BUCKETS; ++i) {
+        index->buckets[i].count = 0;
+    }
+    size_t* slot = realloc(index->slot, buf->capacity * sizeof(size_t));
+    if(slot == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    index->slot = slot;
+    for(size_t i = 0; i < buf->capacity; ++i) {
+        slot[i] = NOT_INDEXED;
+    }
+    indexRange(buf, 0, buf->capacity);
+}
+
+// Create a buffer holding a copy of text
+GapBuffer* createBuffer(const char* text) {
+    size_t length = strlen(text);
+    GapBuffer* buf = (GapBuffer*)malloc(sizeof(GapBuffer));
+    if(buf == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    buf->capacity = length * 2 + 16;
+    buf->data = malloc(buf->capacity);
+    if(buf->data == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    // Start with the cursor at the end, so the gap is after the text
+    memcpy(buf->data, text, length);
+    memset(buf->data + length, 0, buf->capacity - length);
+    buf->gapStart = length;
+    buf->gapEnd = buf->capacity;
+
+    buf->lineTree = NULL;
+    rebuildLineIndex(buf);
+    buf->searchIndex = NULL;
+
+    return buf;
+}
+
+// Drop the search index; searches go back to scanning the text
+void disableSearchIndex(GapBuffer* buf) {
+    SearchIndex* index = buf->searchIndex;
+    if(index == NULL) {
+        return;
+    }
+    for(size_t i = 0; i < INDEX_BUCKETS; ++i) {
+        free(index->buckets[i].positions);
+    }
+    free(index->slot);
+    free(index);
+    buf->searchIndex = NULL;
+}
+
+// Build the search index once; every later edit keeps it up to date
+void enableSearchIndex(GapBuffer* buf) {
+    if(buf->searchIndex != NULL) {
+        return;
+    }
+    buf->searchIndex = calloc(1, sizeof(SearchIndex));
+    if(buf->searchIndex == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    rebuildSearchIndex(buf);
+}
+
+void destroyBuffer(GapBuffer* buf) {
+    disableSearchIndex(buf);
+    free(buf->lineTree);
+    free(buf->data);
+    free(buf);
+}
+
+// Move the gap so it starts at 'position'; only the bytes in between are moved
+static void moveGap(GapBuffer* buf, size_t position) {
+    TRACE_FUNCTION();
+    if(position < buf->gapStart) {
+        // Shift the bytes between position and the gap to the end of the gap
+        size_t count = buf->gapStart - position;
+        TRACE_BYTES(count);
+        unindexRange(buf, position, buf->gapStart);
+        unindexRange(buf, buf->gapEnd - count, buf->gapEnd);
+        storeBytes(buf, buf->gapEnd - count, buf->data + position, count);
+        buf->gapStart -= count;
+        buf->gapEnd -= count;
+        indexRange(buf, position, position + count);
+        indexRange(buf, buf->gapEnd, buf->gapEnd + count);
+    }
+    else if(position > buf->gapStart) {
+        // Shift the bytes just after the gap to its start
+        size_t count = position - buf->gapStart;
+        TRACE_BYTES(count);
+        unindexRange(buf, buf->gapStart, buf->gapStart + count);
+        unindexRange(buf, buf->gapEnd, buf->gapEnd + count);
+        storeBytes(buf, buf->gapStart, buf->data + buf->gapEnd, count);
+        buf->gapStart += count;
+        buf->gapEnd += count;
+        indexRange(buf, buf->gapStart - count, buf->gapStart);
+        indexRange(buf, buf->gapEnd - count, buf->gapEnd);
+    }
+}
+
+// Make the gap at least 'needed' bytes wide
+static void growGap(GapBuffer* buf, size_t needed) {
+    if(buf->gapEnd - buf->gapStart >= needed) {
+        return;
+    }
+    TRACE_FUNCTION();
+
+    size_t length = textLength(buf);
+    TRACE_BYTES(length);
+    size_t newCapacity = buf->capacity * 2;
+    if(newCapacity < length + needed) {
+        newCapacity = length + needed;
+    }
+
+    char* newData = realloc(buf->data, newCapacity);
+    if(newData == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    // Keep the text after the gap at the end of the larger array
+    size_t tail = buf->capacity - buf->gapEnd;
+    memmove(newData + newCapacity - tail, newData + buf->gapEnd, tail);
+    memset(newData + buf->gapStart, 0, newCapacity - tail - buf->gapStart);
+    buf->data = newData;
+    buf->gapEnd = newCapacity - tail;
+    buf->capacity = newCapacity;
+
+    rebuildLineIndex(buf);
+    rebuildSearchIndex(buf);
+}
 
 // Function to display the current text
-void displayText(const char* text) {
-    printf("Current Text: %s\n", text);
+void displayText(const GapBuffer* buf) {
+    printf("Current Text: %.*s%.*s\n", (int)buf->gapStart, buf->data,
+           (int)(buf->capacity - buf->gapEnd), buf->data + buf->gapEnd);
 }
 
 // Function to insert text at a specified position
-void insertText(char** text, const char* insert, int position) {
-    int originalLength = strlen(*text);
-    int insertLength = strlen(insert);
+void insertText(GapBuffer* buf, const char* insert, size_t position) {
+    TRACE_FUNCTION();
+    if(position > textLength(buf)) {
+        printf("Position out of bounds\n");
+        return;
+    }
 
-    // Allocate memory to hold the modified string
-    *text = realloc(*text, originalLength + insertLength + 1);
+    size_t insertLength = strlen(insert);
+    TRACE_BYTES(insertLength);
 
-    // Shift the part of the string after the position to the right
-    memmove(*text + position + insertLength, *text + position, originalLength - position + 1);
+    moveGap(buf, position);
+    growGap(buf, insertLength);
 
-    // Copy the new string into the specified position
-    memcpy(*text + position, insert, insertLength);
+    // The new text fills the front of the gap
+    storeBytes(buf, buf->gapStart, insert, insertLength);
+    buf->gapStart += insertLength;
+    indexRange(buf, buf->gapStart - insertLength, buf->gapStart);
 }
 
-
 // Function to delete a portion of the text
-void deleteText(char* text, int position, int length) {
-    int originalLength = strlen(text);
+void deleteText(GapBuffer* buf, size_t position, size_t length) {
+    TRACE_FUNCTION();
+    size_t total = textLength(buf);
+    if(position > total) {
+        printf("Position out of bounds\n");
+        return;
+    }
+    if(length > total - position) {
+        length = total - position;
+    }
 
-    // Shift the part of the string after the deleted portion to the left
-    memmove(text + position, text + position + length, originalLength - position - length + 1);
+    TRACE_BYTES(length);
+
+    // The deleted characters just become part of the gap
+    moveGap(buf, position);
+    unindexRange(buf, buf->gapEnd, buf->gapEnd + length);
+    buf->gapEnd += length;
 }
 
-// Function to search for a word in the text
-int searchWord(const char* text, const char* word) {
-    char* pos = strstr(text, word);
+/*
+   - The text is searched where it lies, without closing the gap: first the part before the gap, then
+     the matches that straddle the gap, then the part after it.
+   - A straddling match has at most wordLength - 1 bytes on each side, so those two edges are copied into
+     a small buffer and searched there.
+*/
+static const char* findIn(const char* haystack, size_t length, const char* word, size_t wordLength) {
+    if(wordLength > length) {
+        return NULL;
+    }
+    const char* last = haystack + length - wordLength;
+    for(const char* p = haystack; p <= last; ++p) {
+        p = memchr(p, word[0], last - p + 1);
+        if(p == NULL) {
+            return NULL;
+        }
+        if(memcmp(p, word, wordLength) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// Find the first match of word that starts at or after 'from'
+static long searchFrom(const GapBuffer* buf, const char* word, size_t wordLength, size_t from) {
+    size_t before = buf->gapStart;
+    size_t after = buf->capacity - buf->gapEnd;
+    const char* tail = buf->data + buf->gapEnd;
+
+    if(from < before) {
+        const char* pos = findIn(buf->data + from, before - from, word, wordLength);
+        if(pos) {
+            return pos - buf->data;
+        }
+
+        // Matches that straddle the gap
+        if(wordLength > 1 && after > 0) {
+            size_t left = before - from < wordLength - 1 ? before - from : wordLength - 1;
+            size_t right = after < wordLength - 1 ? after : wordLength - 1;
+            char* edge = malloc(left + right);
+            if(edge == NULL) {
+                printf("Memory allocation failed!!\n");
+                exit(1);
+            }
+            memcpy(edge, buf->data + before - left, left);
+            memcpy(edge + left, tail, right);
+            pos = findIn(edge, left + right, word, wordLength);
+            long found = pos ? (long)(before - left + (pos - edge)) : -1;
+            free(edge);
+            if(found != -1) {
+                return found;
+            }
+        }
+    }
+
+    size_t skip = from > before ? from - before : 0;
+    if(skip >= after) {
+        return -1;
+    }
+    const char* pos = findIn(tail + skip, after - skip, word, wordLength);
     if(pos) {
-        return pos - text;
+        return before + (pos - tail);
     }
 
     return -1;
 }
 
+// Does the text at 'position' start with word? The gap may fall anywhere inside it.
+static int matchesAt(const GapBuffer* buf, size_t position, const char* word, size_t wordLength) {
+    size_t before = 0;
+    if(position < buf->gapStart) {
+        before = buf->gapStart - position;
+        if(before > wordLength) {
+            before = wordLength;
+        }
+        if(memcmp(buf->data + position, word, before) != 0) {
+            return 0;
+        }
+    }
+    size_t after = position + before + (buf->gapEnd - buf->gapStart);
+    return memcmp(buf->data + after, word + before, wordLength - before) == 0;
+}
+
+// First match using the search index; wordLength is at least 3
+static long searchIndexed(const GapBuffer* buf, const char* word, size_t wordLength) {
+    const SearchIndex* index = buf->searchIndex;
+    size_t length = textLength(buf);
+    size_t gapLength = buf->gapEnd - buf->gapStart;
+
+    // The rarest trigram of the word has the fewest candidates to check
+    size_t offset = 0;
+    const Posting* rarest = &index->buckets[trigramBucket(word)];
+    for(size_t i = 1; i + 3 <= wordLength; ++i) {
+        const Posting* list = &index->buckets[trigramBucket(word + i)];
+        if(list->count < rarest->count) {
+            rarest = list;
+            offset = i;
+        }
+    }
+
+    size_t best = NOT_INDEXED;
+    for(size_t i = 0; i < rarest->count; ++i) {
+        size_t p = rarest->positions[i];
+        size_t start = p < buf->gapStart ? p : p - gapLength;
+        if(start < offset) {
+            continue;
+        }
+        start -= offset;
+        if(start < best && start + wordLength <= length && matchesAt(buf, start, word, wordLength)) {
+            best = start;
+        }
+    }
+
+    // The trigrams straddling the gap are not in the index
+    for(size_t t = buf->gapStart >= 2 ? buf->gapStart - 2 : 0; t < buf->gapStart; ++t) {
+        if(t < offset) {
+            continue;
+        }
+        size_t start = t - offset;
+        if(start < best && start + wordLength <= length && matchesAt(buf, start, word, wordLength)) {
+            best = start;
+        }
+    }
+    return best == NOT_INDEXED ? -1 : (long)best;
+}
+
+// Function to search for a word in the text
+long searchWord(const GapBuffer* buf, const char* word) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(textLength(buf));
+    size_t wordLength = strlen(word);
+    if(wordLength == 0) {
+        return 0;
+    }
+    // Words shorter than a trigram can't use the index
+    if(buf->searchIndex != NULL && wordLength >= 3) {
+        return searchIndexed(buf, word, wordLength);
+    }
+    return searchFrom(buf, word, wordLength, 0);
+}
+
 // Function to replace a word in the text
-void replaceWord(char** text, const char* oldWord, const char* newWord) {
-    int position = searchWord(*text, oldWord);
+void replaceWord(GapBuffer* buf, const char* oldWord, const char* newWord) {
+    TRACE_FUNCTION();
+    long position = searchWord(buf, oldWord);
 
     if(position != -1) {
-        deleteText(*text, position, strlen(oldWord));
-        insertText(text, newWord, position);
+        deleteText(buf, position, strlen(oldWord));
+        insertText(buf, newWord, position);
+    }
+}
+
+// Copy 'length' characters starting at logical position 'from' into dest, across the gap if needed
+static void copyOut(const GapBuffer* buf, size_t from, size_t length, char* dest) {
+    if(from < buf->gapStart) {
+        size_t count = buf->gapStart - from < length ? buf->gapStart - from : length;
+        memcpy(dest, buf->data + from, count);
+        dest += count;
+        from += count;
+        length -= count;
+    }
+    memcpy(dest, buf->data + buf->gapEnd + (from - buf->gapStart), length);
+}
+
+/*
+   - Replacing every match with replaceWord would rescan from the start after each replacement and shift
+     the text twice per match, which is quadratic, and loops forever when newWord contains oldWord.
+   - replaceAll finds all matches in one left-to-right scan (each search resumes after the previous
+     match, so replacements are never rescanned), works out the final length from the match count,
+     allocates the new array once, and builds it with one pass of copies. The cursor ends up at the end.
+   - It returns the number of replacements.
+*/
+size_t replaceAll(GapBuffer* buf, const char* oldWord, const char* newWord) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(textLength(buf));
+    size_t oldLength = strlen(oldWord);
+    size_t newLength = strlen(newWord);
+    if(oldLength == 0) {
+        return 0;
+    }
+
+    size_t* matches = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    long pos;
+    for(size_t from = 0; (pos = searchFrom(buf, oldWord, oldLength, from)) != -1; from = pos + oldLength) {
+        if(count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            size_t* newMatches = realloc(matches, capacity * sizeof(size_t));
+            if(newMatches == NULL) {
+                printf("Memory allocation failed!!\n");
+                exit(1);
+            }
+            matches = newMatches;
+        }
+        matches[count++] = pos;
+    }
+    if(count == 0) {
+        return 0;
+    }
+
+    size_t length = textLength(buf);
+    size_t finalLength = length - count * oldLength + count * newLength;
+    size_t newCapacity = finalLength * 2 + 16;
+    char* newData = malloc(newCapacity);
+    if(newData == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    size_t out = 0;
+    size_t previous = 0;
+    for(size_t i = 0; i < count; ++i) {
+        copyOut(buf, previous, matches[i] - previous, newData + out);
+        out += matches[i] - previous;
+        memcpy(newData + out, newWord, newLength);
+        out += newLength;
+        previous = matches[i] + oldLength;
+    }
+    copyOut(buf, previous, length - previous, newData + out);
+    memset(newData + finalLength, 0, newCapacity - finalLength);
+
+    free(buf->data);
+    free(matches);
+    buf->data = newData;
+    buf->capacity = newCapacity;
+    buf->gapStart = finalLength;
+    buf->gapEnd = newCapacity;
+    rebuildLineIndex(buf);
+    rebuildSearchIndex(buf);
+
+    return count;
+}
+
+// Newlines in the text before logical position 'position'
+static size_t newlinesBefore(const GapBuffer* buf, size_t position) {
+    if(position <= buf->gapStart) {
+        return physicalNewlines(buf, position);
+    }
+    size_t inGap = physicalNewlines(buf, buf->gapEnd) - physicalNewlines(buf, buf->gapStart);
+    return physicalNewlines(buf, position + (buf->gapEnd - buf->gapStart)) - inGap;
+}
+
+// Logical position of the k-th newline of the text (k >= 1)
+static size_t findNewline(const GapBuffer* buf, size_t k) {
+    size_t before = physicalNewlines(buf, buf->gapStart);
+    if(k <= before) {
+        return physicalFind(buf, k);
+    }
+    size_t inGap = physicalNewlines(buf, buf->gapEnd) - before;
+    return physicalFind(buf, k + inGap) - (buf->gapEnd - buf->gapStart);
+}
+
+// Number of lines in the text (a text without newlines is one line)
+size_t lineCount(const GapBuffer* buf) {
+    return newlinesBefore(buf, textLength(buf)) + 1;
+}
+
+// Position where line 'line' starts (lines count from 1), or -1 if there is no such line
+long positionOfLine(const GapBuffer* buf, size_t line) {
+    if(line == 0 || line > lineCount(buf)) {
+        return -1;
+    }
+    return line == 1 ? 0 : (long)findNewline(buf, line - 1) + 1;
+}
+
+// Line and column (both counting from 1) of a position; returns the line
+size_t lineOfPosition(const GapBuffer* buf, size_t position, size_t* column) {
+    size_t length = textLength(buf);
+    if(position > length) {
+        position = length;
+    }
+    size_t line = newlinesBefore(buf, position) + 1;
+    if(column != NULL) {
+        *column = position - (size_t)positionOfLine(buf, line) + 1;
+    }
+    return line;
+}
+
+/*
+   Piece table: a second representation for very large documents, with undo and redo.
+   - The original text is never modified and added text is only ever appended to the add buffer, so
+     the document is described entirely by a list of pieces: (which buffer, start, length).
+   - Inserting adds one piece (splitting the one it lands in), deleting drops or trims pieces; no
+     document text is ever copied.
+   - The pieces are kept in a balanced tree (a treap: a binary search tree by position that is also a
+     heap on random priorities, which keeps it O(log n) deep with high probability). Every node stores
+     the byte length of its subtree, so a position is found in O(log n).
+   - The tree is persistent: an edit copies only the O(log n) nodes on the path it changes and shares
+     everything else with the previous version. Each version is just a root pointer, so undo and redo
+     swap roots in O(1), and memory grows only with the number of edits and the text they add.
+*/
+typedef struct PieceNode {
+    struct PieceNode* left;
+    struct PieceNode* right;
+    unsigned priority;
+    unsigned char buffer;       // 0: original text, 1: add buffer
+    size_t start;               // Offset of the piece in its buffer
+    size_t length;              // Length of the piece
+    size_t total;               // Length of all pieces in this subtree
+} PieceNode;
+
+#define NODES_PER_BLOCK 4096
+
+typedef struct NodeBlock {
+    struct NodeBlock* next;
+    PieceNode nodes[NODES_PER_BLOCK];
+} NodeBlock;
+
+typedef struct {
+    const char* original;       // Original text, never modified
+    size_t originalLength;
+    char* added;                // Append-only buffer of inserted text
+    size_t addedLength;
+    size_t addedCapacity;
+    PieceNode** versions;       // Root of every version; versions[current] is the document now
+    size_t versionCount;
+    size_t versionCapacity;
+    size_t current;
+    NodeBlock* blocks;          // Nodes are never freed individually, versions share them
+    size_t blockUsed;
+    unsigned seed;
+    void* mapping;              // Set by openPieceTable: the file mapped as the original text
+    struct stat fileInfo;       // The opened file as it was when mapped
+} PieceTable;
+
+static PieceNode* newPiece(PieceTable* pt, unsigned char buffer, size_t start, size_t length) {
+    if(pt->blocks == NULL || pt->blockUsed == NODES_PER_BLOCK) {
+        NodeBlock* block = malloc(sizeof(NodeBlock));
+        if(block == NULL) {
+            printf("Memory allocation failed!!\n");
+            exit(1);
+        }
+        block->next = pt->blocks;
+        pt->blocks = block;
+        pt->blockUsed = 0;
+    }
+
+    PieceNode* node = &pt->blocks->nodes[pt->blockUsed++];
+    // xorshift: cheap pseudo-random priorities
+    pt->seed ^= pt->seed << 13;
+    pt->seed ^= pt->seed >> 17;
+    pt->seed ^= pt->seed << 5;
+    node->priority = pt->seed;
+    node->left = NULL;
+    node->right = NULL;
+    node->buffer = buffer;
+    node->start = start;
+    node->length = length;
+    node->total = length;
+    return node;
+}
+
+static size_t subtreeLength(const PieceNode* node) {
+    return node ? node->total : 0;
+}
+
+// Copy a node so it can be changed without touching older versions
+static PieceNode* copyPiece(PieceTable* pt, const PieceNode* node) {
+    PieceNode* copy = newPiece(pt, node->buffer, node->start, node->length);
+    *copy = *node;
+    return copy;
+}
+
+static PieceNode* updatePiece(PieceNode* node) {
+    node->total = subtreeLength(node->left) + node->length + subtreeLength(node->right);
+    return node;
+}
+
+// Join two trees, every position of a before every position of b
+static PieceNode* mergePieces(PieceTable* pt, PieceNode* a, PieceNode* b) {
+    if(a == NULL) return b;
+    if(b == NULL) return a;
+
+    if(a->priority > b->priority) {
+        PieceNode* node = copyPiece(pt, a);
+        node->right = mergePieces(pt, a->right, b);
+        return updatePiece(node);
+    }
+    PieceNode* node = copyPiece(pt, b);
+    node->left = mergePieces(pt, a, b->left);
+    return updatePiece(node);
+}
+
+// Split a tree into the first 'position' bytes and the rest, cutting a piece in two if needed
+static void splitPieces(PieceTable* pt, PieceNode* node, size_t position, PieceNode** left, PieceNode** right) {
+    if(node == NULL) {
+        *left = *right = NULL;
+        return;
+    }
+
+    size_t leftLength = subtreeLength(node->left);
+    if(position <= leftLength) {
+        PieceNode* copy = copyPiece(pt, node);
+        splitPieces(pt, node->left, position, left, &copy->left);
+        *right = updatePiece(copy);
+    }
+    else if(position >= leftLength + node->length) {
+        PieceNode* copy = copyPiece(pt, node);
+        splitPieces(pt, node->right, position - leftLength - node->length, &copy->right, right);
+        *left = updatePiece(copy);
+    }
+    else {
+        // The cut falls inside this piece: both halves keep its priority, so the heap order still holds
+        size_t offset = position - leftLength;
+        PieceNode* head = newPiece(pt, node->buffer, node->start, offset);
+        PieceNode* tail = newPiece(pt, node->buffer, node->start + offset, node->length - offset);
+        head->priority = tail->priority = node->priority;
+        head->left = node->left;
+        tail->right = node->right;
+        *left = updatePiece(head);
+        *right = updatePiece(tail);
+    }
+}
+
+// Make 'root' the newest version; any redo history is dropped
+static void pushVersion(PieceTable* pt, PieceNode* root) {
+    if(pt->current + 1 == pt->versionCapacity) {
+        size_t newCapacity = pt->versionCapacity * 2;
+        PieceNode** newVersions = realloc(pt->versions, newCapacity * sizeof(PieceNode*));
+        if(newVersions == NULL) {
+            printf("Memory allocation failed!!\n");
+            exit(1);
+        }
+        pt->versions = newVersions;
+        pt->versionCapacity = newCapacity;
+    }
+    pt->versions[++pt->current] = root;
+    pt->versionCount = pt->current + 1;
+}
+
+// Create a piece table over 'text'. The text is referenced, not copied, and must outlive the table.
+PieceTable* createPieceTable(const char* text, size_t length) {
+    PieceTable* pt = calloc(1, sizeof(PieceTable));
+    if(pt == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    pt->original = text;
+    pt->originalLength = length;
+    pt->seed = 2463534242u;
+    pt->versionCapacity = 16;
+    pt->versions = malloc(pt->versionCapacity * sizeof(PieceNode*));
+    if(pt->versions == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    pt->versions[0] = length ? newPiece(pt, 0, 0, length) : NULL;
+    pt->versionCount = 1;
+    pt->current = 0;
+    return pt;
+}
+
+void destroyPieceTable(PieceTable* pt) {
+    while(pt->blocks != NULL) {
+        NodeBlock* next = pt->blocks->next;
+        free(pt->blocks);
+        pt->blocks = next;
+    }
+    free(pt->versions);
+    free(pt->added);
+    if(pt->mapping != NULL) {
+        munmap(pt->mapping, pt->originalLength);
+    }
+    free(pt);
+}
+
+size_t pieceTableLength(const PieceTable* pt) {
+    return subtreeLength(pt->versions[pt->current]);
+}
+
+// Insert 'length' bytes of text at position
+void pieceTableInsert(PieceTable* pt, size_t position, const char* text, size_t length) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(length);
+    if(position > pieceTableLength(pt)) {
+        printf("Position out of bounds\n");
+        return;
+    }
+    if(length == 0) {
+        return;
+    }
+
+    // Append the text to the add buffer; the buffer may move, pieces only store offsets into it
+    if(pt->addedLength + length > pt->addedCapacity) {
+        size_t newCapacity = pt->addedCapacity ? pt->addedCapacity * 2 : 4096;
+        while(newCapacity < pt->addedLength + length) {
+            newCapacity *= 2;
+        }
+        char* newAdded = realloc(pt->added, newCapacity);
+        if(newAdded == NULL) {
+            printf("Memory allocation failed!!\n");
+            exit(1);
+        }
+        pt->added = newAdded;
+        pt->addedCapacity = newCapacity;
+    }
+    memcpy(pt->added + pt->addedLength, text, length);
+
+    PieceNode* left;
+    PieceNode* right;
+    splitPieces(pt, pt->versions[pt->current], position, &left, &right);
+    PieceNode* piece = newPiece(pt, 1, pt->addedLength, length);
+    pt->addedLength += length;
+
+    pushVersion(pt, mergePieces(pt, mergePieces(pt, left, piece), right));
+}
+
+// Delete 'length' bytes starting at position
+void pieceTableDelete(PieceTable* pt, size_t position, size_t length) {
+    TRACE_FUNCTION();
+    size_t total = pieceTableLength(pt);
+    if(position > total) {
+        printf("Position out of bounds\n");
+        return;
+    }
+    if(length > total - position) {
+        length = total - position;
+    }
+    if(length == 0) {
+        return;
+    }
+
+    PieceNode* left;
+    PieceNode* rest;
+    PieceNode* removed;
+    PieceNode* right;
+    TRACE_BYTES(length);
+    splitPieces(pt, pt->versions[pt->current], position, &left, &rest);
+    splitPieces(pt, rest, length, &removed, &right);
+
+    pushVersion(pt, mergePieces(pt, left, right));
+}
+
+// Step back one edit; returns 0 if there is nothing to undo
+int pieceTableUndo(PieceTable* pt) {
+    if(pt->current == 0) {
+        return 0;
+    }
+    pt->current--;
+    return 1;
+}
+
+// Reapply an undone edit; returns 0 if there is nothing to redo
+int pieceTableRedo(PieceTable* pt) {
+    if(pt->current + 1 >= pt->versionCount) {
+        return 0;
+    }
+    pt->current++;
+    return 1;
+}
+
+static const char* pieceText(const PieceTable* pt, const PieceNode* node) {
+    return (node->buffer ? pt->added : pt->original) + node->start;
+}
+
+// Copy up to 'length' bytes starting at 'position' into dest; returns the number of bytes copied
+static size_t readPieces(const PieceTable* pt, const PieceNode* node, size_t position, size_t length, char* dest) {
+    if(node == NULL || length == 0) {
+        return 0;
+    }
+
+    size_t copied = 0;
+    size_t leftLength = subtreeLength(node->left);
+    if(position < leftLength) {
+        copied = readPieces(pt, node->left, position, length, dest);
+    }
+    if(copied < length && position + copied < leftLength + node->length) {
+        size_t offset = position + copied - leftLength;
+        size_t count = node->length - offset;
+        if(count > length - copied) {
+            count = length - copied;
+        }
+        memcpy(dest + copied, pieceText(pt, node) + offset, count);
+        copied += count;
+    }
+    if(copied < length) {
+        size_t from = position + copied - leftLength - node->length;
+        copied += readPieces(pt, node->right, from, length - copied, dest + copied);
+    }
+    return copied;
+}
+
+size_t pieceTableRead(const PieceTable* pt, size_t position, size_t length, char* dest) {
+    if(position >= pieceTableLength(pt)) {
+        return 0;
+    }
+    return readPieces(pt, pt->versions[pt->current], position, length, dest);
+}
+
+// Visit the pieces in document order
+static int forEachPiece(const PieceTable* pt, const PieceNode* node,
+                        int (*visit)(void* ctx, const char* text, size_t length), void* ctx) {
+    if(node == NULL) {
+        return 0;
     }
+    if(forEachPiece(pt, node->left, visit, ctx)) return 1;
+    if(visit(ctx, pieceText(pt, node), node->length)) return 1;
+    return forEachPiece(pt, node->right, visit, ctx);
 }
 
+static int printPiece(void* ctx, const char* text, size_t length) {
+    fwrite(text, 1, length, (FILE*)ctx);
+    return 0;
+}
+
+void displayPieceTable(const PieceTable* pt) {
+    printf("Current Text: ");
+    forEachPiece(pt, pt->versions[pt->current], printPiece, stdout);
+    printf("\n");
+}
+
+/*
+   - Searching feeds the pieces one after another through a KMP matcher, so a match that spans several
+     pieces is found without joining them, in O(document + word) time.
+*/
+typedef struct {
+    const char* word;
+    size_t wordLength;
+    const size_t* failure;      // failure[i]: length of the longest proper border of word[0..i]
+    size_t matched;             // Characters of word matched so far
+    size_t position;            // Characters consumed so far
+    long found;
+} PieceSearch;
+
+static int searchPiece(void* ctx, const char* text, size_t length) {
+    PieceSearch* s = ctx;
+    for(size_t i = 0; i < length; ++i) {
+        while(s->matched > 0 && text[i] != s->word[s->matched]) {
+            s->matched = s->failure[s->matched - 1];
+        }
+        if(text[i] == s->word[s->matched]) {
+            s->matched++;
+        }
+        if(s->matched == s->wordLength) {
+            s->found = (long)(s->position + i + 1 - s->wordLength);
+            return 1;
+        }
+    }
+    s->position += length;
+    return 0;
+}
+
+long pieceTableSearch(const PieceTable* pt, const char* word) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(pieceTableLength(pt));
+    size_t wordLength = strlen(word);
+    if(wordLength == 0) {
+        return 0;
+    }
+
+    size_t* failure = malloc(wordLength * sizeof(size_t));
+    if(failure == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    failure[0] = 0;
+    for(size_t i = 1, k = 0; i < wordLength; ++i) {
+        while(k > 0 && word[i] != word[k]) {
+            k = failure[k - 1];
+        }
+        if(word[i] == word[k]) {
+            k++;
+        }
+        failure[i] = k;
+    }
+
+    PieceSearch s = {word, wordLength, failure, 0, 0, -1};
+    forEachPiece(pt, pt->versions[pt->current], searchPiece, &s);
+    free(failure);
+    return s.found;
+}
+
+/*
+   Files: the piece table edits a file without ever loading it.
+   - openPieceTable maps the file read-only and uses the mapping as the original text. Opening takes the
+     same time for any file size, and the kernel reads pages only when they are displayed, searched
+     or saved, so memory grows with what is touched and what is added, not with the file.
+   - savePieceTable normally streams the pieces into a temporary file next to the target and renames
+     it over the target. The rename is atomic, so a crash leaves either the old or the new file, and
+     the old file stays alive under the mapping until it is unmapped.
+   - When the document is still the whole opened file followed by new text, and the file on disk is
+     unchanged, only the new text is appended. The file is never rewritten in place otherwise: the
+     mapping, and every undo version, still reads its bytes.
+*/
 
-int main() {
+// Open a file for editing; returns NULL if it can't be opened or mapped
+PieceTable* openPieceTable(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        printf("Cannot open %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0) {
+        printf("Cannot stat %s: %s\n", path, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+
+    // An empty file can't be mapped; it simply has no original text
+    void* mapping = NULL;
+    if(info.st_size > 0) {
+        mapping = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(mapping == MAP_FAILED) {
+            printf("Cannot map %s: %s\n", path, strerror(errno));
+            close(fd);
+            return NULL;
+        }
+    }
+    // The mapping keeps the file alive on its own
+    close(fd);
+
+    PieceTable* pt = createPieceTable(mapping, (size_t)info.st_size);
+    pt->mapping = mapping;
+    pt->fileInfo = info;
+    return pt;
+}
+
+static int writeAll(int fd, const char* data, size_t length) {
+    while(length > 0) {
+        ssize_t written = write(fd, data, length);
+        if(written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += written;
+        length -= (size_t)written;
+    }
+    return 0;
+}
 
-    char* text = malloc(100*sizeof(char));  // Initial allocation
-    strcpy(text, "Hello, this is a simple text editor.");
+typedef struct {
+    int fd;
+    size_t written;
+    int failed;
+} PieceWriter;
+
+static int writePiece(void* ctx, const char* text, size_t length) {
+    PieceWriter* w = ctx;
+    if(writeAll(w->fd, text, length) != 0) {
+        w->failed = 1;
+        return 1;
+    }
+    w->written += length;
+    return 0;
+}
+
+typedef struct {
+    size_t position;            // Bytes of the original matched so far
+    int broken;                 // A piece was found out of place
+} PrefixCheck;
+
+static int checkPrefix(const PieceTable* pt, const PieceNode* node, PrefixCheck* check) {
+    if(node == NULL) {
+        return 0;
+    }
+    if(checkPrefix(pt, node->left, check)) return 1;
+    if(check->position == pt->originalLength) return 1;
+    if(node->buffer != 0 || node->start != check->position) {
+        check->broken = 1;
+        return 1;
+    }
+    check->position += node->length;
+    return checkPrefix(pt, node->right, check);
+}
+
+// Length of the document prefix that is the whole original text, untouched, or 0 if there is none
+static size_t originalPrefix(const PieceTable* pt) {
+    PrefixCheck check = {0, 0};
+    checkPrefix(pt, pt->versions[pt->current], &check);
+    return !check.broken && check.position == pt->originalLength ? check.position : 0;
+}
+
+/*
+   - Appends the pieces after 'skip' bytes to the file and flushes them to disk; returns the bytes
+     written or -1.
+   - If the write or the flush fails, the file is truncated back to its opened size, so a failed
+     append leaves no partial tail behind.
+*/
+static long appendPieces(const PieceTable* pt, const char* path, size_t skip) {
+    struct stat info;
+    if(stat(path, &info) != 0 || info.st_dev != pt->fileInfo.st_dev || info.st_ino != pt->fileInfo.st_ino ||
+       info.st_size != pt->fileInfo.st_size || info.st_mtim.tv_sec != pt->fileInfo.st_mtim.tv_sec ||
+       info.st_mtim.tv_nsec != pt->fileInfo.st_mtim.tv_nsec) {
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_APPEND);
+    if(fd < 0) {
+        return -1;
+    }
+    size_t length = pieceTableLength(pt) - skip;
+    char* tail = malloc(length ? length : 1);
+    if(tail == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    pieceTableRead(pt, skip, length, tail);
+    int failed = writeAll(fd, tail, length) != 0 || fsync(fd) != 0;
+    free(tail);
+    if(failed && ftruncate(fd, pt->fileInfo.st_size) != 0) {
+        printf("Cannot undo partial append to %s: %s\n", path, strerror(errno));
+    }
+    if(close(fd) != 0 || failed) {
+        return -1;
+    }
+    return (long)length;
+}
+
+/*
+   - Saves the current version to 'path'; returns the number of bytes written, or -1 on failure, in
+     which case the file at 'path' is unchanged (unless truncating a failed append back off failed as
+     well, which is reported).
+   - Either way the data is on disk before success is returned: the append path calls fsync on the
+     file, the full rewrite on the temporary file before renaming it over 'path'.
+*/
+long savePieceTable(PieceTable* pt, const char* path) {
+    TRACE_FUNCTION();
+    TRACE_BYTES(pieceTableLength(pt));
+    // Fast path: the opened file plus appended text
+    size_t prefix = pt->mapping != NULL ? originalPrefix(pt) : 0;
+    if(prefix > 0) {
+        long written = appendPieces(pt, path, prefix);
+        if(written >= 0) {
+            // The file now holds more than the mapping; never append to it on this basis again
+            pt->fileInfo.st_ino = 0;
+            return written;
+        }
+    }
+
+    size_t pathLength = strlen(path);
+    char* tempPath = malloc(pathLength + 8);
+    if(tempPath == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    memcpy(tempPath, path, pathLength);
+    memcpy(tempPath + pathLength, ".XXXXXX", 8);
+
+    int fd = mkstemp(tempPath);
+    if(fd < 0) {
+        printf("Cannot create %s: %s\n", tempPath, strerror(errno));
+        free(tempPath);
+        return -1;
+    }
+
+    // Keep the permissions of the file being replaced
+    struct stat info;
+    fchmod(fd, stat(path, &info) == 0 ? (info.st_mode & 07777) : 0644);
+
+    PieceWriter w = {fd, 0, 0};
+    forEachPiece(pt, pt->versions[pt->current], writePiece, &w);
+    int failed = w.failed || fsync(fd) != 0;
+    failed |= close(fd) != 0;
+    if(failed || rename(tempPath, path) != 0) {
+        printf("Cannot save %s: %s\n", path, strerror(errno));
+        unlink(tempPath);
+        free(tempPath);
+        return -1;
+    }
+    free(tempPath);
+    return (long)w.written;
+}
+
+
+int main(int argc, char* argv[]) {
+
+    // ./SimpleTextEditor <file> <line>: append a line to a file of any size without loading it
+    if(argc == 3) {
+        PieceTable* doc = openPieceTable(argv[1]);
+        if(doc == NULL) {
+            return 1;
+        }
+        size_t length = pieceTableLength(doc);
+        pieceTableInsert(doc, length, argv[2], strlen(argv[2]));
+        pieceTableInsert(doc, pieceTableLength(doc), "\n", 1);
+
+        long written = savePieceTable(doc, argv[1]);
+        destroyPieceTable(doc);
+        if(written < 0) {
+            return 1;
+        }
+        printf("Opened %zu bytes, wrote %ld bytes\n", length, written);
+        return 0;
+    }
+
+    GapBuffer* text = createBuffer("Hello, this is a simple text editor.");
 
     displayText(text);
 
     // Insert text
-    insertText(&text, " very", 13);
+    insertText(text, " very", 13);
     displayText(text);
 
     // Delete text
@@ -68,27 +1318,66 @@ int main() {
     displayText(text);
 
     // Search for a word
-    int pos = searchWord(text, "text");
+    long pos = searchWord(text, "text");
     if(pos != -1){
-        printf("Word 'text' found at position %d\n", pos);
+        printf("Word 'text' found at position %ld\n", pos);
     }
     else {
         printf("Word 'text' not found!\n");
     }
 
     // Replace a word
-    replaceWord(&text, "simple", "basic");
+    replaceWord(text, "simple", "basic");
     displayText(text);
 
+    // Replace every occurrence in one pass, even when the new word contains the old one
+    size_t replaced = replaceAll(text, "e", "ee");
+    printf("Replaced %zu occurrences -> ", replaced);
+    displayText(text);
+
+    // Line and column lookups
+    insertText(text, "\nsecond line\nthird line", 12);
+    displayText(text);
+    size_t column;
+    size_t line = lineOfPosition(text, 20, &column);
+    printf("Position 20 is line %zu, column %zu; line 3 starts at position %ld of %zu lines\n",
+           line, column, positionOfLine(text, 3), lineCount(text));
+
+    // Index the text once for repeated searches; edits keep the index current
+    enableSearchIndex(text);
+    deleteText(text, 0, 7);
+    printf("Indexed search: 'third' at position %ld, 'editor' at position %ld\n",
+           searchWord(text, "third"), searchWord(text, "editor"));
+
     // Free allocated memory
-    free(text);
+    destroyBuffer(text);
+
+    // The same edits on a piece table, which can also undo and redo them
+    const char* original = "Hello, this is a simple text editor.";
+    PieceTable* doc = createPieceTable(original, strlen(original));
+    pieceTableInsert(doc, 13, " very", 5);
+    pieceTableDelete(doc, 5, 7);
+    displayPieceTable(doc);
+
+    pieceTableUndo(doc);
+    printf("After undo -> ");
+    displayPieceTable(doc);
+    pieceTableRedo(doc);
+    printf("After redo -> ");
+    displayPieceTable(doc);
+    printf("Word 'text' found at position %ld\n", pieceTableSearch(doc, "text"));
+
+    destroyPieceTable(doc);
 
     return 0;
 }
 
 /*
 
-### Example
+### Example: why a flat string is slow to edit
+
+This walkthrough shows what inserting into a plain `char*` costs: everything after the insert position is shifted
+and the block may be reallocated on every call. The gap buffer above avoids both by keeping spare room at the cursor.
 
 Imagine you have the following text:
 
@@ -0,0 +1,345 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+   A sorting library for arrays of fixed-type integers.
+   - qsort calls the comparator through a function pointer for every comparison, so it can never be
+     inlined, and comparators written as `a - b` overflow when the values are far apart.
+   - DEFINE_SORT generates a sort for one element type at compile time, so the comparison is a plain
+     `<` that the compiler inlines.
+   - The integer sorts use an LSD radix sort for large arrays: no comparisons at all, O(n) per pass.
+   - The order is a parameter (ASCENDING or DESCENDING) instead of a second comparator.
+*/
+enum { ASCENDING = 0, DESCENDING = 1 };
+
+/*
+   Introsort: quicksort with a median-of-three pivot, insertion sort for short ranges, and heapsort
+   once the recursion gets deeper than 2 * log2(n), so the worst case stays O(n log n).
+   - 'before(a, b)' is true when a must come before b; it is expanded inline, never called.
+   - The recursion goes into the smaller half and loops on the larger one, so the stack stays O(log n).
+*/
+#define SORT_INSERTION_LIMIT 16
+
+#define DEFINE_SORT_ORDER(name, type, before)                                           \
+static void name##Sift(type* arr, size_t root, size_t n) {                              \
+    type value = arr[root];                                                             \
+    size_t child;                                                                       \
+    while((child = 2 * root + 1) < n) {                                                 \
+        if(child + 1 < n && before(arr[child], arr[child + 1])) {                       \
+            child++;                                                                    \
+        }                                                                               \
+        if(!before(value, arr[child])) {                                                \
+            break;                                                                      \
+        }                                                                               \
+        arr[root] = arr[child];                                                         \
+        root = child;                                                                   \
+    }                                                                                   \
+    arr[root] = value;                                                                  \
+}                                                                                       \
+                                                                                        \
+static void name##Heap(type* arr, size_t n) {                                           \
+    for(size_t i = n / 2; i > 0; --i) {                                                 \
+        name##Sift(arr, i - 1, n);                                                      \
+    }                                                                                   \
+    for(size_t end = n - 1; end > 0; --end) {                                           \
+        type temp = arr[0];                                                             \
+        arr[0] = arr[end];                                                              \
+        arr[end] = temp;                                                                \
+        name##Sift(arr, 0, end);                                                        \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+static void name##Insertion(type* arr, size_t n) {                                      \
+    for(size_t i = 1; i < n; ++i) {                                                     \
+        type value = arr[i];                                                            \
+        size_t j = i;                                                                   \
+        while(j > 0 && before(value, arr[j - 1])) {                                     \
+            arr[j] = arr[j - 1];                                                        \
+            j--;                                                                        \
+        }                                                                               \
+        arr[j] = value;                                                                 \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+static void name##Loop(type* arr, size_t n, int depth) {                                \
+    while(n > SORT_INSERTION_LIMIT) {                                                   \
+        if(depth-- == 0) {                                                              \
+            name##Heap(arr, n);                                                         \
+            return;                                                                     \
+        }                                                                               \
+        /* Order first, middle and last; the middle one becomes the pivot */            \
+        type* mid = arr + n / 2;                                                        \
+        type* last = arr + n - 1;                                                       \
+        type temp;                                                                      \
+        if(before(*mid, *arr)) { temp = *mid; *mid = *arr; *arr = temp; }               \
+        if(before(*last, *mid)) { temp = *last; *last = *mid; *mid = temp; }            \
+        if(before(*mid, *arr)) { temp = *mid; *mid = *arr; *arr = temp; }               \
+        type pivot = *mid;                                                              \
+                                                                                        \
+        /* Hoare partition: [arr, hi] before or equal to the pivot, the rest after */   \
+        type* lo = arr;                                                                 \
+        type* hi = last;                                                                \
+        for(;;) {                                                                       \
+            while(before(*lo, pivot)) lo++;                                             \
+            while(before(pivot, *hi)) hi--;                                             \
+            if(lo >= hi) break;                                                         \
+            temp = *lo; *lo = *hi; *hi = temp;                                          \
+            lo++;                                                                       \
+            hi--;                                                                       \
+        }                                                                               \
+        size_t split = (size_t)(hi - arr) + 1;                                          \
+        if(split < n - split) {                                                         \
+            name##Loop(arr, split, depth);                                              \
+            arr += split;                                                               \
+            n -= split;                                                                 \
+        }                                                                               \
+        else {                                                                          \
+            name##Loop(arr + split, n - split, depth);                                  \
+            n = split;                                                                  \
+        }                                                                               \
+    }                                                                                   \
+    name##Insertion(arr, n);                                                            \
+}
+
+#define SORT_LESS(a, b) ((a) < (b))
+#define SORT_GREATER(a, b) ((a) > (b))
+
+// Defines 'void name(type* arr, size_t n, int order)' for any type with < and >
+#define DEFINE_SORT(name, type)                                                         \
+DEFINE_SORT_ORDER(name##Asc, type, SORT_LESS)                                           \
+DEFINE_SORT_ORDER(name##Desc, type, SORT_GREATER)                                       \
+                                                                                        \
+void name(type* arr, size_t n, int order) {                                             \
+    int depth = 0;                                                                      \
+    for(size_t i = n; i > 1; i >>= 1) {                                                 \
+        depth += 2;                                                                     \
+    }                                                                                   \
+    if(order == DESCENDING) {                                                           \
+        name##DescLoop(arr, n, depth);                                                  \
+    }                                                                                   \
+    else {                                                                              \
+        name##AscLoop(arr, n, depth);                                                   \
+    }                                                                                   \
+}
+
+DEFINE_SORT(introSortInt32, int32_t)
+DEFINE_SORT(introSortUInt32, uint32_t)
+DEFINE_SORT(introSortInt64, int64_t)
+DEFINE_SORT(introSortUInt64, uint64_t)
+DEFINE_SORT(introSortDouble, double)
+
+/*
+   LSD radix sort: the keys are distributed by their lowest byte, then the next one, and so on. Each
+   pass is stable, so after the last pass the keys are in order.
+   - All the byte histograms are counted in a single read of the array before the first pass.
+   - A pass where every key has the same byte would only copy the array, so it is skipped; small keys
+     in a 64-bit array cost only the passes for the bytes they actually use.
+   - Signed keys are sorted as unsigned after flipping the sign bit, which maps INT_MIN..INT_MAX onto
+     0..UINT_MAX in order. Descending order flips every bit, which reverses the order.
+   - Below RADIX_THRESHOLD elements the fixed cost of the histograms outweighs the gain, and introsort
+     is used instead.
+*/
+#define RADIX_THRESHOLD 256
+
+#define DEFINE_RADIX_SORT(name, type, bytes)                                            \
+static void name(type* arr, size_t n, type flip) {                                      \
+    type* buffer = malloc(n * sizeof(type));                                            \
+    if(buffer == NULL) {                                                                \
+        printf("Memory allocation failed!!\n");                                         \
+        exit(1);                                                                        \
+    }                                                                                   \
+                                                                                        \
+    size_t (*counts)[256] = calloc(bytes, sizeof(*counts));                             \
+    if(counts == NULL) {                                                                \
+        printf("Memory allocation failed!!\n");                                         \
+        exit(1);                                                                        \
+    }                                                                                   \
+    for(size_t i = 0; i < n; ++i) {                                                     \
+        type key = arr[i] ^ flip;                                                       \
+        for(int b = 0; b < (bytes); ++b) {                                              \
+            counts[b][(key >> (8 * b)) & 0xFF]++;                                       \
+        }                                                                               \
+    }                                                                                   \
+                                                                                        \
+    type* src = arr;                                                                    \
+    type* dest = buffer;                                                                \
+    for(int b = 0; b < (bytes); ++b) {                                                  \
+        int shift = 8 * b;                                                              \
+        if(counts[b][((src[0] ^ flip) >> shift) & 0xFF] == n) {                         \
+            continue;                                                                   \
+        }                                                                               \
+        /* Turn the counts into the first output index of every byte value */           \
+        size_t offsets[256];                                                            \
+        size_t sum = 0;                                                                 \
+        for(int d = 0; d < 256; ++d) {                                                  \
+            offsets[d] = sum;                                                           \
+            sum += counts[b][d];                                                        \
+        }                                                                               \
+        for(size_t i = 0; i < n; ++i) {                                                 \
+            dest[offsets[((src[i] ^ flip) >> shift) & 0xFF]++] = src[i];                \
+        }                                                                               \
+        type* temp = src;                                                               \
+        src = dest;                                                                     \
+        dest = temp;                                                                    \
+    }                                                                                   \
+                                                                                        \
+    if(src != arr) {                                                                    \
+        memcpy(arr, src, n * sizeof(type));                                             \
+    }                                                                                   \
+    free(counts);                                                                       \
+    free(buffer);                                                                       \
+}
+
+DEFINE_RADIX_SORT(radixSort32, uint32_t, 4)
+DEFINE_RADIX_SORT(radixSort64, uint64_t, 8)
+
+// Sort 32-bit signed integers
+void sortInt32(int32_t* arr, size_t n, int order) {
+    if(n < RADIX_THRESHOLD) {
+        introSortInt32(arr, n, order);
+        return;
+    }
+    radixSort32((uint32_t*)arr, n, order == DESCENDING ? 0x7FFFFFFFu : 0x80000000u);
+}
+
+// Sort 32-bit unsigned integers
+void sortUInt32(uint32_t* arr, size_t n, int order) {
+    if(n < RADIX_THRESHOLD) {
+        introSortUInt32(arr, n, order);
+        return;
+    }
+    radixSort32(arr, n, order == DESCENDING ? 0xFFFFFFFFu : 0);
+}
+
+// Sort 64-bit signed integers
+void sortInt64(int64_t* arr, size_t n, int order) {
+    if(n < RADIX_THRESHOLD) {
+        introSortInt64(arr, n, order);
+        return;
+    }
+    radixSort64((uint64_t*)arr, n, order == DESCENDING ? 0x7FFFFFFFFFFFFFFFull : 0x8000000000000000ull);
+}
+
+// Sort 64-bit unsigned integers
+void sortUInt64(uint64_t* arr, size_t n, int order) {
+    if(n < RADIX_THRESHOLD) {
+        introSortUInt64(arr, n, order);
+        return;
+    }
+    radixSort64(arr, n, order == DESCENDING ? 0xFFFFFFFFFFFFFFFFull : 0);
+}
+
+/*
+   Benchmark: ./SortLibrary bench [maxElements]
+   - Sorts random 32- and 64-bit integers with qsort, the generated introsort and the radix sort, for
+     10^6 elements and every power of ten up to maxElements (default 10^7; 10^9 needs about 16 GB).
+   - Each result is checked against the previous one, so a wrong sort can't post a good time.
+*/
+static double elapsedNs(struct timespec begin, struct timespec end) {
+    return (end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec);
+}
+
+#define TIME_ONCE(result, body)                                 \
+    do {                                                        \
+        struct timespec begin, end;                             \
+        clock_gettime(CLOCK_MONOTONIC, &begin);                 \
+        body;                                                   \
+        clock_gettime(CLOCK_MONOTONIC, &end);                   \
+        result = elapsedNs(begin, end) / 1e6;                   \
+    } while(0)
+
+static int compareInt32(const void* a, const void* b) {
+    int32_t x = *(const int32_t*)a;
+    int32_t y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compareInt64(const void* a, const void* b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t nextRandom(uint64_t* state) {
+    // splitmix64
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+#define BENCH_TYPE(label, type, qsortCompare, introSort, radixSort)                     \
+    do {                                                                                \
+        type* input = malloc(n * sizeof(type));                                         \
+        type* work = malloc(n * sizeof(type));                                          \
+        type* expected = malloc(n * sizeof(type));                                      \
+        if(input == NULL || work == NULL || expected == NULL) {                         \
+            printf("Memory allocation failed!!\n");                                     \
+            exit(1);                                                                    \
+        }                                                                               \
+        uint64_t state = n;                                                             \
+        for(size_t i = 0; i < n; ++i) {                                                 \
+            input[i] = (type)nextRandom(&state);                                        \
+        }                                                                               \
+        double qsortMs, introMs, radixMs;                                               \
+        memcpy(expected, input, n * sizeof(type));                                      \
+        TIME_ONCE(qsortMs, qsort(expected, n, sizeof(type), qsortCompare));             \
+        memcpy(work, input, n * sizeof(type));                                          \
+        TIME_ONCE(introMs, introSort(work, n, ASCENDING));                              \
+        int ok = memcmp(work, expected, n * sizeof(type)) == 0;                         \
+        memcpy(work, input, n * sizeof(type));                                          \
+        TIME_ONCE(radixMs, radixSort(work, n, ASCENDING));                              \
+        ok &= memcmp(work, expected, n * sizeof(type)) == 0;                            \
+        printf("%-8s %12zu %10.1fms %10.1fms %10.1fms %8.1fx %s\n", label, n, qsortMs,  \
+               introMs, radixMs, qsortMs / radixMs, ok ? "" : "MISMATCH");              \
+        free(input);                                                                    \
+        free(work);                                                                     \
+        free(expected);                                                                 \
+    } while(0)
+
+static int runBenchmark(size_t maxElements) {
+    printf("%-8s %12s %12s %12s %12s %9s\n", "type", "elements", "qsort", "introsort", "radix", "speedup");
+    for(size_t n = 1000000; n <= maxElements; n *= 10) {
+        BENCH_TYPE("int32", int32_t, compareInt32, introSortInt32, sortInt32);
+        BENCH_TYPE("int64", int64_t, compareInt64, introSortInt64, sortInt64);
+    }
+    return 0;
+}
+
+void printArray(const int32_t arr[], size_t size) {
+    for(size_t i = 0; i < size; ++i) {
+        printf("%d ", arr[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark(argc > 2 ? strtoull(argv[2], NULL, 10) : 10000000);
+    }
+
+    // Values far apart enough to overflow an `a - b` comparator
+    int32_t arr[] = {5, -2000000000, 8, 2000000000, 1, 4, -7};
+    size_t size = sizeof(arr) / sizeof(arr[0]);
+
+    printf("Original Array: ");
+    printArray(arr, size);
+
+    sortInt32(arr, size, ASCENDING);
+    printf("Sorted Array in Ascending order: ");
+    printArray(arr, size);
+
+    sortInt32(arr, size, DESCENDING);
+    printf("Sorted Array in Descending order: ");
+    printArray(arr, size);
+
+    // The generated sorts work for any type with < and >
+    double values[] = {2.5, -1.0, 3.75, 0.0};
+    introSortDouble(values, 4, ASCENDING);
+    printf("Sorted doubles: %g %g %g %g\n", values[0], values[1], values[2], values[3]);
+
+    return 0;
+}
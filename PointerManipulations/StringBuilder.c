@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+   A length-tracked string builder.
+   - Appending with stringConcat has to walk to the end of `dest` on every call, so building a string
+     from k pieces is O(k * n), and nothing stops it from writing past the end of the buffer.
+   - The builder remembers where the string ends and how much room is left, so every append is a
+     bounds-checked copy to a known position.
+   - The buffer grows by doubling, like DynamicArray, which makes appends O(1) amortized.
+   - The text is always null-terminated, so `data` can be passed to any C string function.
+*/
+typedef struct {
+    char* data;         // Pointer to the text, always null-terminated
+    size_t length;      // Number of characters in the text, excluding the terminator
+    size_t capacity;    // Number of characters that fit before the buffer must grow, excluding the terminator
+} StringBuilder;
+
+// Initialize the String Builder
+StringBuilder* initBuilder(size_t capacity) {
+    StringBuilder* sb = (StringBuilder*)malloc(sizeof(StringBuilder));
+    if(sb == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    if(capacity == 0) {
+        capacity = 16;
+    }
+    sb->data = malloc(capacity + 1);
+    if(sb->data == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    sb->data[0] = '\0';
+    sb->length = 0;
+    sb->capacity = capacity;
+
+    return sb;
+}
+
+// Make room for at least 'extra' more characters
+void reserveBuilder(StringBuilder* sb, size_t extra) {
+    if(sb->capacity - sb->length >= extra) {
+        return;
+    }
+
+    size_t newCapacity = sb->capacity * 2;
+    if(newCapacity < sb->length + extra) {
+        newCapacity = sb->length + extra;
+    }
+
+    char* newData = realloc(sb->data, newCapacity + 1);
+    if(newData == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    sb->data = newData;
+    sb->capacity = newCapacity;
+}
+
+// Append 'length' characters from str
+void appendLength(StringBuilder* sb, const char* str, size_t length) {
+    reserveBuilder(sb, length);
+    memcpy(sb->data + sb->length, str, length);
+    sb->length += length;
+    sb->data[sb->length] = '\0';
+}
+
+// Append a null-terminated string
+void appendString(StringBuilder* sb, const char* str) {
+    appendLength(sb, str, strlen(str));
+}
+
+// Append a single character
+void appendChar(StringBuilder* sb, char c) {
+    reserveBuilder(sb, 1);
+    sb->data[sb->length++] = c;
+    sb->data[sb->length] = '\0';
+}
+
+/*
+   - Integers are formatted without sprintf: there is no format string to parse and no locale to consult.
+   - Digits are produced two at a time from a 200-byte table of the pairs "00".."99", right to left into
+     a small stack buffer, and then copied into the builder in one go.
+*/
+static const char digitPairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Append an unsigned integer in decimal
+void appendUnsigned(StringBuilder* sb, unsigned long long value) {
+    char buffer[20];            // 18446744073709551615 has 20 digits
+    char* p = buffer + sizeof(buffer);
+
+    while(value >= 100) {
+        unsigned pair = (unsigned)(value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        memcpy(p, &digitPairs[pair], 2);
+    }
+    if(value >= 10) {
+        p -= 2;
+        memcpy(p, &digitPairs[value * 2], 2);
+    }
+    else {
+        *--p = (char)('0' + value);
+    }
+
+    appendLength(sb, p, buffer + sizeof(buffer) - p);
+}
+
+// Append a signed integer in decimal
+void appendInt(StringBuilder* sb, long long value) {
+    if(value < 0) {
+        appendChar(sb, '-');
+        // Negate in unsigned arithmetic so LLONG_MIN doesn't overflow
+        appendUnsigned(sb, 0ULL - (unsigned long long)value);
+    }
+    else {
+        appendUnsigned(sb, (unsigned long long)value);
+    }
+}
+
+// Reset the text to empty, keeping the buffer for reuse
+void clearBuilder(StringBuilder* sb) {
+    sb->length = 0;
+    sb->data[0] = '\0';
+}
+
+/*
+   - Hands the buffer to the caller without copying it; the caller frees it with free().
+   - The builder itself is destroyed. If length is not NULL, it receives the string length.
+*/
+char* detachBuilder(StringBuilder* sb, size_t* length) {
+    char* data = sb->data;
+    if(length != NULL) {
+        *length = sb->length;
+    }
+    free(sb);
+    return data;
+}
+
+// Destroy the String Builder
+void destroyBuilder(StringBuilder* sb) {
+    free(sb->data);
+    free(sb);
+}
+
+int main() {
+
+    // Initialize a String Builder with a small capacity so it has to grow
+    StringBuilder* sb = initBuilder(8);
+
+    // Assemble a response body piece by piece
+    appendString(sb, "{\"items\": [");
+    for(int i = 1; i <= 5; ++i) {
+        if(i > 1) {
+            appendString(sb, ", ");
+        }
+        appendInt(sb, i * -1000);
+    }
+    appendString(sb, "], \"total\": ");
+    appendUnsigned(sb, 18446744073709551615ULL);
+    appendChar(sb, '}');
+
+    printf("Built string: %s\n", sb->data);
+    printf("Length: %zu, Capacity: %zu\n", sb->length, sb->capacity);
+
+    // Take ownership of the buffer without a copy
+    size_t length;
+    char* body = detachBuilder(sb, &length);
+    printf("Detached %zu characters: %s\n", length, body);
+    free(body);
+
+    return 0;
+}
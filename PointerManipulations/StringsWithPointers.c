@@ -1,49 +1,155 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 /*
-   - We start with a pointer pointing to the beginning of the string.
-   - We iterate through the string until we encounter the null character `'\0'`.
-   - The difference between the current pointer and the starting pointer gives us the string length.
+   Word-at-a-time scanning used by stringLength, stringCopy and stringConcat:
+   - Instead of testing one character per iteration, a whole block (32 bytes with AVX2, 16 with SSE2,
+     8 bytes in a plain 64-bit word otherwise) is tested for a zero byte at once.
+   - zeroMask() returns a mask with the bits of the zero bytes set; BYTE_BITS is how many mask bits
+     belong to one byte, so the index of the first '\0' is ctz(mask) / BYTE_BITS.
+   - Every load is aligned to the block size. An aligned block never straddles a page boundary, so
+     reading the bytes after the terminator (or before the start of the string) can never fault,
+     even though they don't belong to the string. This is also why AddressSanitizer may flag these loops.
 */
+#if defined(__AVX2__)
+#define BLOCK_SIZE 32
+#define BYTE_BITS 1
+typedef uint32_t BlockMask;
+
+static inline BlockMask zeroMask(const char* block) {
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    return (BlockMask)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+}
+#elif defined(__SSE2__)
+#define BLOCK_SIZE 16
+#define BYTE_BITS 1
+typedef uint32_t BlockMask;
 
+static inline BlockMask zeroMask(const char* block) {
+    __m128i v = _mm_load_si128((const __m128i*)block);
+    return (BlockMask)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128()));
+}
+#else
+#define BLOCK_SIZE 8
+#define BYTE_BITS 8
+typedef uint64_t BlockMask;
+typedef uint64_t __attribute__((may_alias)) Word;
+
+// SWAR: sets bit 7 of every byte that is zero; exact, so no borrow leaks into neighbouring bytes
+static inline BlockMask zeroMask(const char* block) {
+    const uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+    uint64_t v = *(const Word*)block;
+    uint64_t mask = ~(((v & low7) + low7) | v | low7);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    mask = __builtin_bswap64(mask);
+#endif
+    return mask;
+}
+#endif
+
+#define FIRST_ZERO(mask) ((size_t)__builtin_ctzll(mask) / BYTE_BITS)
+
+// Long strings are scanned four blocks per iteration; a group aligned to 4 blocks can't straddle a page either
+#define GROUP_SIZE (4 * BLOCK_SIZE)
+
+static inline int groupHasZero(const char* group) {
+#if defined(__AVX2__)
+    const __m256i* p = (const __m256i*)group;
+    __m256i low = _mm256_min_epu8(_mm256_load_si256(p), _mm256_load_si256(p + 1));
+    __m256i high = _mm256_min_epu8(_mm256_load_si256(p + 2), _mm256_load_si256(p + 3));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(low, high), _mm256_setzero_si256()));
+#elif defined(__SSE2__)
+    const __m128i* p = (const __m128i*)group;
+    __m128i low = _mm_min_epu8(_mm_load_si128(p), _mm_load_si128(p + 1));
+    __m128i high = _mm_min_epu8(_mm_load_si128(p + 2), _mm_load_si128(p + 3));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(low, high), _mm_setzero_si128()));
+#else
+    return (zeroMask(group) | zeroMask(group + BLOCK_SIZE) |
+            zeroMask(group + 2 * BLOCK_SIZE) | zeroMask(group + 3 * BLOCK_SIZE)) != 0;
+#endif
+}
+
+/*
+   - We start with a pointer pointing to the beginning of the string.
+   - We step back to the block boundary at or before it and discard the mask bits of the bytes before the string.
+   - We then test one aligned block per iteration until we reach a group boundary, and from there four
+     blocks per iteration until a group contains the null character `'\0'`.
+   - The offset of the block plus the position of the zero byte inside it gives us the string length.
+*/
 int stringLength(const char* str) {
-    const char* ptr = str;
-    while(*ptr != '\0') {
-        ptr++;
+    size_t offset = (uintptr_t)str % BLOCK_SIZE;
+    const char* block = str - offset;
+
+    BlockMask mask = zeroMask(block) >> (offset * BYTE_BITS);
+    if(mask) {
+        return FIRST_ZERO(mask);
     }
 
-    return ptr-str;
+    for(block += BLOCK_SIZE; ; block += BLOCK_SIZE) {
+        if((uintptr_t)block % GROUP_SIZE == 0) {
+            while(!groupHasZero(block)) {
+                block += GROUP_SIZE;
+            }
+        }
+
+        mask = zeroMask(block);
+        if(mask) {
+            return block - str + FIRST_ZERO(mask);
+        }
+    }
 }
 
 /*
-   - We copy each character from the source string (`src`) to the destination string (`dest`) using pointers.
-   - The loop continues until the null character in the source string is reached.
-   - Finally, we ensure that the destination string is null-terminated.
+   - We copy the source string (`src`) to the destination string (`dest`) a block at a time.
+   - The first, partial block runs up to the next alignment boundary of `src`; after that every block read is aligned.
+   - A block without a zero byte is copied whole; in the block holding the null character only the
+     bytes up to and including it are copied, so the destination is null-terminated and nothing past it is written.
+   - It returns a pointer to the terminator in `dest`, which stringConcat uses.
 */
-void stringCopy(char* dest, const char* src) {
-    while(*src != '\0') {
-        *dest = *src;
-        dest++;
-        src++;
+static char* copyBlocks(char* dest, const char* src) {
+    size_t offset = (uintptr_t)src % BLOCK_SIZE;
+    const char* block = src - offset;
+
+    BlockMask mask = zeroMask(block) >> (offset * BYTE_BITS);
+    if(mask) {
+        size_t length = FIRST_ZERO(mask);
+        memcpy(dest, src, length + 1);
+        return dest + length;
+    }
+
+    memcpy(dest, src, BLOCK_SIZE - offset);
+    dest += BLOCK_SIZE - offset;
+
+    for(block += BLOCK_SIZE; ; block += BLOCK_SIZE) {
+        mask = zeroMask(block);
+        if(mask) {
+            size_t length = FIRST_ZERO(mask);
+            memcpy(dest, block, length + 1);
+            return dest + length;
+        }
+        memcpy(dest, block, BLOCK_SIZE);
+        dest += BLOCK_SIZE;
     }
-    *dest = '\0';
+}
+
+void stringCopy(char* dest, const char* src) {
+    copyBlocks(dest, src);
 }
 
 /*
-   - First, we move the destination pointer (`dest`) to the end of the first string.
-   - Then, we copy each character from the source string (`src`) to the end of the destination string.
-   - After copying, we null-terminate the concatenated string.
+   - First, we find the end of the destination string (`dest`) with the same block scan as stringLength.
+   - Then, we copy the source string (`src`) to the end of the destination string a block at a time.
+   - The copy includes the null character, so the concatenated string is terminated.
 */
 void stringConcat(char* dest, const char* src) {
-    while(*dest != '\0') {
-        dest++;
-    }
-    while(*src != '\0') {
-        *dest = *src;
-        dest++;
-        src++;
-    }
-    *dest = '\0';
+    copyBlocks(dest + stringLength(dest), src);
 }
 
 /*
@@ -64,11 +170,26 @@ int stringCompare(const char* str1, const char* str2) {
    - We use two pointers: one at the beginning (`str`) and one at the end (`end`) of the string.
    - We swap the characters at these pointers and move the pointers towards each other until they meet or cross.
    - This effectively reverses the string in place.
+   - When SSSE3 is available, 16 bytes from each end are reversed with one byte shuffle and swapped,
+     and only the short middle is handled a character at a time.
 */
 void stringReverse(char* str) {
     char* end = str + stringLength(str)-1;
     char temp;
 
+#if defined(__SSSE3__)
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    while(end - str >= 31) {
+        __m128i head = _mm_loadu_si128((const __m128i*)str);
+        __m128i tail = _mm_loadu_si128((const __m128i*)(end - 15));
+        _mm_storeu_si128((__m128i*)str, _mm_shuffle_epi8(tail, reverse));
+        _mm_storeu_si128((__m128i*)(end - 15), _mm_shuffle_epi8(head, reverse));
+
+        str += 16;
+        end -= 16;
+    }
+#endif
+
     while(str < end) {
         temp = *str;
         *str = *end;
@@ -79,8 +200,83 @@ void stringReverse(char* str) {
     }
 }
 
+/*
+   Benchmark: ./StringsWithPointers bench
+   - Times stringLength, stringCopy and stringConcat against strlen, strcpy and strcat from the C library
+     for string lengths from 1 byte to 1 MB.
+   - The iteration count is scaled so each measurement touches roughly the same number of bytes.
+   - The empty asm statement with a "memory" clobber stops the compiler from hoisting or deleting the
+     calls, since it can't prove the buffers are unchanged between iterations.
+*/
+static double elapsedNs(struct timespec begin, struct timespec end) {
+    return (end.tv_sec - begin.tv_sec) * 1e9 + (end.tv_nsec - begin.tv_nsec);
+}
+
+#define TIME_LOOP(result, iterations, body)                     \
+    do {                                                        \
+        struct timespec begin, end;                             \
+        clock_gettime(CLOCK_MONOTONIC, &begin);                 \
+        for(size_t it = 0; it < (iterations); ++it) {           \
+            body;                                               \
+            __asm__ __volatile__("" ::: "memory");              \
+        }                                                       \
+        clock_gettime(CLOCK_MONOTONIC, &end);                   \
+        result = elapsedNs(begin, end) / (iterations);          \
+    } while(0)
+
+static int runBenchmark(void) {
+    const size_t lengths[] = {1, 7, 16, 33, 64, 256, 1024, 4096, 65536, 1 << 20};
+    const size_t maxLength = 1 << 20;
+    const size_t misalign = 1;      // Strings start this far into src so they aren't block aligned
+
+    // Room for the longest string and its terminator after the misaligned start. Both buffers are whole,
+    // aligned groups, so the aligned reads past a terminator stay inside them (and AddressSanitizer is quiet)
+    size_t srcSize = (misalign + maxLength + 1 + GROUP_SIZE - 1) / GROUP_SIZE * GROUP_SIZE;
+    size_t destSize = (2 * maxLength + 1 + GROUP_SIZE - 1) / GROUP_SIZE * GROUP_SIZE;
+    char* src = aligned_alloc(GROUP_SIZE, srcSize);
+    char* dest = aligned_alloc(GROUP_SIZE, destSize);
+    if(src == NULL || dest == NULL) {
+        printf("Memory allocation failed!\n");
+        return 1;
+    }
+    memset(src, 'a', misalign + maxLength);
+    memset(dest, 'b', 2 * maxLength);
+
+    volatile size_t sink = 0;
+    printf("%8s %12s %12s %12s %12s %12s %12s\n", "length", "stringLength", "strlen",
+           "stringCopy", "strcpy", "stringConcat", "strcat");
+
+    for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+        size_t length = lengths[i];
+        size_t iterations = (size_t)(256 << 20) / (length + 16);
+        char* s = src + misalign;
+        s[length] = '\0';
+
+        double ours, libc, oursCopy, libcCopy, oursConcat, libcConcat;
+        TIME_LOOP(ours, iterations, sink += stringLength(s));
+        TIME_LOOP(libc, iterations, sink += strlen(s));
+        TIME_LOOP(oursCopy, iterations, stringCopy(dest, s));
+        TIME_LOOP(libcCopy, iterations, strcpy(dest, s));
+        dest[length] = 'b';
+        TIME_LOOP(oursConcat, iterations, (dest[length] = '\0', stringConcat(dest, s)));
+        TIME_LOOP(libcConcat, iterations, (dest[length] = '\0', strcat(dest, s)));
+
+        printf("%8zu %10.1fns %10.1fns %10.1fns %10.1fns %10.1fns %10.1fns\n", length,
+               ours, libc, oursCopy, libcCopy, oursConcat, libcConcat);
+        s[length] = 'a';
+    }
+
+    free(src);
+    free(dest);
+    return 0;
+}
+
 // Main function to demonstrate the string operations
-int main() {
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark();
+    }
+
     char str1[20] = "Hello";
     char str2[20] = "World";
     char str3[30];
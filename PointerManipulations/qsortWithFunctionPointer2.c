@@ -6,6 +6,9 @@ The odd numbers should be sorted in descending order and the even numbers should
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
 
 int comparator(const void* p, const void* q) {
     // Get the values at the given addresses
@@ -13,13 +16,14 @@ int comparator(const void* p, const void* q) {
     int r = *(const int*)q;
 
     // If both odd, put the greater of these two values first
+    // (compare rather than subtract: r - l overflows when the values are far apart)
     if((l & 1) && (r & 1)) {
-        return (r - l);
+        return (r > l) - (r < l);
     }
 
     // If both even, put the smaller of two values first
     if(!(l & 1) && !(r & 1)) {
-        return (l - r);
+        return (l > r) - (l < r);
     }
 
     // l is even, put r first
@@ -31,6 +35,182 @@ int comparator(const void* p, const void* q) {
     return -1;
 }
 
+/*
+   Sorting by key: the comparator above re-tests the parity of both values on every one of the
+   n log n comparisons. Instead, the whole ordering can be encoded once per element as an unsigned
+   key whose plain numeric order is the order we want, and the keys sorted without any comparator.
+   - Odd numbers first: the parity goes in the top bit, 0 for odd and 1 for even.
+   - Signed to unsigned: flipping the sign bit maps INT_MIN..INT_MAX onto 0..UINT_MAX in order.
+   - Descending: flipping every bit of the value reverses its order.
+*/
+typedef uint64_t (*KeyFunction)(const void* element);
+
+uint64_t oddDescEvenAscKey(const void* element) {
+    int value = *(const int*)element;
+    uint32_t bits = (uint32_t)value ^ 0x80000000u;
+    if(value & 1) {
+        return ~bits;                           // Odd: top bit 0, descending
+    }
+    return (1ull << 32) | bits;                 // Even: top bit 1, ascending
+}
+
+/*
+   - The keys are sorted with an LSD radix sort, one pass per byte, stable, so equal keys keep the
+     original order. A pass where every key has the same byte is skipped; the odd/even key above
+     needs 5 of the 8 passes.
+   - Each key travels with the index of its element, and the elements are moved once at the end.
+*/
+typedef struct {
+    uint64_t key;
+    size_t index;
+} KeyedIndex;
+
+static void radixSortKeys(KeyedIndex* items, size_t n) {
+    KeyedIndex* buffer = malloc(n * sizeof(KeyedIndex));
+    size_t (*counts)[256] = calloc(8, sizeof(*counts));
+    if(buffer == NULL || counts == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    for(size_t i = 0; i < n; ++i) {
+        for(int b = 0; b < 8; ++b) {
+            counts[b][(items[i].key >> (8 * b)) & 0xFF]++;
+        }
+    }
+
+    KeyedIndex* src = items;
+    KeyedIndex* dest = buffer;
+    for(int b = 0; b < 8; ++b) {
+        int shift = 8 * b;
+        if(counts[b][(src[0].key >> shift) & 0xFF] == n) {
+            continue;
+        }
+        size_t offsets[256];
+        size_t sum = 0;
+        for(int d = 0; d < 256; ++d) {
+            offsets[d] = sum;
+            sum += counts[b][d];
+        }
+        for(size_t i = 0; i < n; ++i) {
+            dest[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        KeyedIndex* temp = src;
+        src = dest;
+        dest = temp;
+    }
+
+    if(src != items) {
+        memcpy(items, src, n * sizeof(KeyedIndex));
+    }
+    free(counts);
+    free(buffer);
+}
+
+// Sort n elements of 'size' bytes in increasing order of keyOf(element); stable
+void sortByKey(void* base, size_t n, size_t size, KeyFunction keyOf) {
+    if(n < 2) {
+        return;
+    }
+    KeyedIndex* items = malloc(n * sizeof(KeyedIndex));
+    char* sorted = malloc(n * size);
+    if(items == NULL || sorted == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+
+    // The key function is called exactly once per element
+    for(size_t i = 0; i < n; ++i) {
+        items[i].key = keyOf((char*)base + i * size);
+        items[i].index = i;
+    }
+    radixSortKeys(items, n);
+
+    for(size_t i = 0; i < n; ++i) {
+        memcpy(sorted + i * size, (char*)base + items[i].index * size, size);
+    }
+    memcpy(base, sorted, n * size);
+    free(sorted);
+    free(items);
+}
+
+/*
+   Partition, then sort: orderings of the form "everything matching a predicate first, each group in
+   its own order" don't need a combined key at all.
+   - One pass moves the matching elements to the front (two pointers swapping from both ends).
+   - Each group is then sorted on its own with a radix sort on the int value alone, which needs only
+     4 passes, and in the group's own direction.
+*/
+enum { ASCENDING = 0, DESCENDING = 1 };
+
+static void radixSortInts(int* arr, size_t n, int order) {
+    if(n < 2) {
+        return;
+    }
+    uint32_t flip = order == DESCENDING ? 0x7FFFFFFFu : 0x80000000u;
+    int* buffer = malloc(n * sizeof(int));
+    if(buffer == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    size_t counts[4][256] = {{0}};
+    for(size_t i = 0; i < n; ++i) {
+        uint32_t key = (uint32_t)arr[i] ^ flip;
+        counts[0][key & 0xFF]++;
+        counts[1][(key >> 8) & 0xFF]++;
+        counts[2][(key >> 16) & 0xFF]++;
+        counts[3][key >> 24]++;
+    }
+
+    int* src = arr;
+    int* dest = buffer;
+    for(int b = 0; b < 4; ++b) {
+        int shift = 8 * b;
+        if(counts[b][(((uint32_t)src[0] ^ flip) >> shift) & 0xFF] == n) {
+            continue;
+        }
+        size_t offsets[256];
+        size_t sum = 0;
+        for(int d = 0; d < 256; ++d) {
+            offsets[d] = sum;
+            sum += counts[b][d];
+        }
+        for(size_t i = 0; i < n; ++i) {
+            dest[offsets[(((uint32_t)src[i] ^ flip) >> shift) & 0xFF]++] = src[i];
+        }
+        int* temp = src;
+        src = dest;
+        dest = temp;
+    }
+
+    if(src != arr) {
+        memcpy(arr, src, n * sizeof(int));
+    }
+    free(buffer);
+}
+
+// Elements matching 'predicate' first, in firstOrder, then the rest in secondOrder
+void partitionSort(int* arr, size_t n, int (*predicate)(int), int firstOrder, int secondOrder) {
+    size_t lo = 0;
+    size_t hi = n;
+    while(lo < hi) {
+        if(predicate(arr[lo])) {
+            lo++;
+        }
+        else {
+            hi--;
+            int temp = arr[lo];
+            arr[lo] = arr[hi];
+            arr[hi] = temp;
+        }
+    }
+    radixSortInts(arr, lo, firstOrder);
+    radixSortInts(arr + lo, n - lo, secondOrder);
+}
+
+int isOdd(int value) {
+    return value & 1;
+}
+
 void printArray(int arr[], int n) {
     for(int i = 0; i < n; ++i) {
         printf("%d ", arr[i]);
@@ -38,15 +218,85 @@ void printArray(int arr[], int n) {
     printf("\n");
 }
 
-int main() {
+/*
+   Benchmark: ./qsortWithFunctionPointer2 bench [elements]
+   - Sorts the same random ints with qsort and the comparator, with sortByKey, and with partitionSort,
+     and checks that all three agree.
+*/
+static double elapsedMs(struct timespec begin, struct timespec end) {
+    return (end.tv_sec - begin.tv_sec) * 1e3 + (end.tv_nsec - begin.tv_nsec) / 1e6;
+}
+
+static int runBenchmark(size_t n) {
+    int* input = malloc(n * sizeof(int));
+    int* expected = malloc(n * sizeof(int));
+    int* work = malloc(n * sizeof(int));
+    if(input == NULL || expected == NULL || work == NULL) {
+        printf("Memory allocation failed!!\n");
+        exit(1);
+    }
+    uint32_t state = 2463534242u;
+    for(size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        input[i] = (int)state;
+    }
+
+    struct timespec begin, end;
+    memcpy(expected, input, n * sizeof(int));
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    qsort(expected, n, sizeof(int), comparator);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-14s %10zu ints %10.1fms\n", "qsort", n, elapsedMs(begin, end));
+
+    memcpy(work, input, n * sizeof(int));
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    sortByKey(work, n, sizeof(int), oddDescEvenAscKey);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-14s %10zu ints %10.1fms  %s\n", "sortByKey", n, elapsedMs(begin, end),
+           memcmp(work, expected, n * sizeof(int)) == 0 ? "matches" : "MISMATCH");
+
+    memcpy(work, input, n * sizeof(int));
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    partitionSort(work, n, isOdd, DESCENDING, ASCENDING);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%-14s %10zu ints %10.1fms  %s\n", "partitionSort", n, elapsedMs(begin, end),
+           memcmp(work, expected, n * sizeof(int)) == 0 ? "matches" : "MISMATCH");
+
+    free(input);
+    free(expected);
+    free(work);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark(argc > 2 ? strtoull(argv[2], NULL, 10) : 10000000);
+    }
 
     int arr[] = {1, 6, 5, 2, 3, 9, 4, 7, 8};
 
     int size = sizeof(arr)/sizeof(arr[0]);
+    int byKey[sizeof(arr)/sizeof(arr[0])];
+    int partitioned[sizeof(arr)/sizeof(arr[0])];
+    memcpy(byKey, arr, sizeof(arr));
+    memcpy(partitioned, arr, sizeof(arr));
+
     qsort((void*)arr, size, sizeof(arr[0]), comparator);
 
     printf("Output Array: \n");
     printArray(arr, size);
 
+    // The same order from a key computed once per element
+    sortByKey(byKey, size, sizeof(byKey[0]), oddDescEvenAscKey);
+    printf("Sorted by key: \n");
+    printArray(byKey, size);
+
+    // And by splitting odds from evens first
+    partitionSort(partitioned, size, isOdd, DESCENDING, ASCENDING);
+    printf("Partitioned, then sorted: \n");
+    printArray(partitioned, size);
+
     return 0;
-}
\ No newline at end of file
+}
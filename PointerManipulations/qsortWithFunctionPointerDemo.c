@@ -1,11 +1,15 @@
 #include <stdio.h>
+#include <stdlib.h>
 
+// Compare instead of subtracting: a - b overflows when the values are far apart
 int compareAsc(const void* a, const void* b) {
-    return (*(int*)a - *(int*)b);
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
 }
 
 int comapreDesc(const void* a, const void* b) {
-    return (*(int*)b - *(int*)a);
+    return compareAsc(b, a);
 }
 
 void printArray(int arr[], int size) {
@@ -8,38 +8,805 @@ than the original string, the function should return the original string.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "../Instrumentation/Trace.h"
+
+/*
+   - runLength() counts how many bytes starting at p equal *p.
+   - Instead of comparing one byte at a time, a whole block (32 bytes with AVX2, 16 with SSE2) is compared
+     against the run byte at once; the first zero bit of the comparison mask is where the run ends.
+   - The very common case of a run of length 1 is answered before any vector work is done.
+*/
+static size_t runLength(const unsigned char* p, const unsigned char* end) {
+    const unsigned char* start = p;
+    unsigned char symbol = *p++;
+
+    if(p == end || *p != symbol) {
+        return 1;
+    }
+
+#if defined(__AVX2__)
+    __m256i wanted32 = _mm256_set1_epi8((char)symbol);
+    while(end - p >= 32) {
+        unsigned mask = (unsigned)_mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), wanted32));
+        if(mask != 0xFFFFFFFFu) {
+            return p - start + __builtin_ctz(~mask);
+        }
+        p += 32;
+    }
+#endif
+#if defined(__SSE2__)
+    __m128i wanted = _mm_set1_epi8((char)symbol);
+    while(end - p >= 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), wanted));
+        if(mask != 0xFFFF) {
+            return p - start + __builtin_ctz(~mask);
+        }
+        p += 16;
+    }
+#endif
+
+    while(p < end && *p == symbol) {
+        p++;
+    }
+    return p - start;
+}
+
+/*
+   Binary RLE format: every run is stored as the symbol byte followed by the run length as a varint
+   (7 bits per byte, least significant group first, high bit set on every byte except the last).
+   - A run of length r takes 1 + ceil(bits(r) / 7) bytes, which is never more than 2 * r, so 2 * n is an
+     exact bound: it is reached when no two neighbouring bytes are equal.
+   - Any byte value can be a symbol, so arbitrary binary data round-trips.
+*/
+#define RLE_ERROR ((size_t)-1)
+
+size_t rleCompressBound(size_t length) {
+    return 2 * length;
+}
+
+static unsigned char* writeVarint(unsigned char* out, size_t value) {
+    while(value >= 0x80) {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    return out;
+}
+
+// Compress 'length' bytes of src into dst, which must hold rleCompressBound(length) bytes. Returns the compressed size.
+size_t rleCompress(const unsigned char* src, size_t length, unsigned char* dst) {
+    const unsigned char* end = src + length;
+    unsigned char* out = dst;
+
+    while(src < end) {
+        size_t run = runLength(src, end);
+        *out++ = *src;
+        out = writeVarint(out, run);
+        src += run;
+    }
+
+    return out - dst;
+}
+
+static const unsigned char* readVarint(const unsigned char* in, const unsigned char* end, size_t* value) {
+    size_t result = 0;
+    for(int shift = 0; in < end && shift < 64; shift += 7) {
+        unsigned char byte = *in++;
+        result |= (size_t)(byte & 0x7F) << shift;
+        if(!(byte & 0x80)) {
+            *value = result;
+            return in;
+        }
+    }
+    return NULL;    // Truncated or overlong varint
+}
+
+// Size of the data rleDecompress would produce, or RLE_ERROR if src is malformed
+size_t rleDecompressedSize(const unsigned char* src, size_t length) {
+    const unsigned char* end = src + length;
+    size_t total = 0;
+
+    while(src < end) {
+        size_t run;
+        src = readVarint(src + 1, end, &run);
+        if(src == NULL || run == 0 || total + run < total) {
+            return RLE_ERROR;
+        }
+        total += run;
+    }
+    return total;
+}
+
+// Decompress src into dst, which holds dstCapacity bytes. Returns the decompressed size, or RLE_ERROR.
+size_t rleDecompress(const unsigned char* src, size_t length, unsigned char* dst, size_t dstCapacity) {
+    const unsigned char* end = src + length;
+    unsigned char* out = dst;
+
+    while(src < end) {
+        unsigned char symbol = *src;
+        size_t run;
+        src = readVarint(src + 1, end, &run);
+        if(src == NULL || run == 0 || run > dstCapacity - (size_t)(out - dst)) {
+            return RLE_ERROR;
+        }
+        memset(out, symbol, run);
+        out += run;
+    }
+
+    return out - dst;
+}
+
+/*
+   Streaming mode: the same binary format, produced and consumed chunk by chunk.
+   - The encoder only remembers the run that is still open at the end of a chunk (its symbol and length),
+     so a run split across two chunks is still written once, and memory use doesn't depend on the input size.
+   - A chunk can complete the open run plus at most one run per input byte, so rleFeedBound(length)
+     bytes of output always suffice; rleEncoderFlush writes the open run and needs at most RLE_FLUSH_BOUND.
+*/
+#define RLE_FLUSH_BOUND 11     // Symbol byte + 10-byte varint of a 64-bit run length
+
+typedef struct {
+    int hasRun;             // Whether a run is open
+    unsigned char symbol;   // Symbol of the open run
+    size_t run;             // Length of the open run so far
+} RleEncoder;
+
+size_t rleFeedBound(size_t length) {
+    return rleCompressBound(length) + RLE_FLUSH_BOUND;
+}
+
+void rleEncoderInit(RleEncoder* enc) {
+    enc->hasRun = 0;
+    enc->symbol = 0;
+    enc->run = 0;
+}
+
+// Compress one chunk into dst, which must hold rleFeedBound(length) bytes. Returns the number of bytes written.
+size_t rleEncoderFeed(RleEncoder* enc, const unsigned char* src, size_t length, unsigned char* dst) {
+    const unsigned char* end = src + length;
+    unsigned char* out = dst;
+
+    while(src < end) {
+        if(enc->hasRun && *src == enc->symbol) {
+            size_t run = runLength(src, end);
+            enc->run += run;
+            src += run;
+            if(src == end) {
+                break;      // The run may continue in the next chunk
+            }
+        }
+        if(enc->hasRun) {
+            *out++ = enc->symbol;
+            out = writeVarint(out, enc->run);
+        }
+        enc->hasRun = 1;
+        enc->symbol = *src;
+        enc->run = 0;
+    }
+
+    return out - dst;
+}
+
+// Write the open run, if any, into dst (at least RLE_FLUSH_BOUND bytes). Returns the number of bytes written.
+size_t rleEncoderFlush(RleEncoder* enc, unsigned char* dst) {
+    unsigned char* out = dst;
+    if(enc->hasRun) {
+        *out++ = enc->symbol;
+        out = writeVarint(out, enc->run);
+        enc->hasRun = 0;
+        enc->run = 0;
+    }
+    return out - dst;
+}
+
+/*
+   - The decoder keeps a half-read run header (symbol and the varint bits seen so far) and the number of
+     bytes of the current run still to be written, so both the input and the output can be cut anywhere.
+   - rleDecoderFeed advances *src and *dst as it goes and stops when the input is used up or the output
+     is full; the caller drains the output and calls it again.
+*/
+typedef struct {
+    int inHeader;           // 1 while reading a varint, 0 while waiting for a symbol
+    unsigned char symbol;   // Symbol of the current run
+    size_t run;             // Varint value accumulated so far
+    int shift;              // Bit position of the next varint group
+    size_t pending;         // Bytes of the current run not yet written
+} RleDecoder;
+
+void rleDecoderInit(RleDecoder* dec) {
+    memset(dec, 0, sizeof(*dec));
+}
+
+// Returns 0 on success or -1 if the stream is malformed
+int rleDecoderFeed(RleDecoder* dec, const unsigned char** src, const unsigned char* srcEnd,
+                   unsigned char** dst, unsigned char* dstEnd) {
+    const unsigned char* in = *src;
+    unsigned char* out = *dst;
+
+    for(;;) {
+        if(dec->pending > 0) {
+            size_t room = dstEnd - out;
+            size_t count = dec->pending < room ? dec->pending : room;
+            memset(out, dec->symbol, count);
+            out += count;
+            dec->pending -= count;
+            if(dec->pending > 0) {
+                break;      // Output is full
+            }
+        }
+        if(in == srcEnd) {
+            break;
+        }
+
+        if(!dec->inHeader) {
+            dec->symbol = *in++;
+            dec->inHeader = 1;
+            dec->run = 0;
+            dec->shift = 0;
+            continue;
+        }
+
+        unsigned char byte = *in++;
+        if(dec->shift >= 64) {
+            *src = in;
+            *dst = out;
+            return -1;      // Overlong varint
+        }
+        dec->run |= (size_t)(byte & 0x7F) << dec->shift;
+        dec->shift += 7;
+        if(!(byte & 0x80)) {
+            if(dec->run == 0) {
+                *src = in;
+                *dst = out;
+                return -1;
+            }
+            dec->inHeader = 0;
+            dec->pending = dec->run;
+        }
+    }
+
+    *src = in;
+    *dst = out;
+    return 0;
+}
+
+// Whether the stream ended on a run boundary with everything written out
+int rleDecoderFinished(const RleDecoder* dec) {
+    return !dec->inHeader && dec->pending == 0;
+}
+
+/*
+   LZ mode: replaces repeated phrases with a back-reference (offset, length) to an earlier copy.
+   RLE only helps with runs of one byte; "abcabcabc" has no runs at all, but from position 3 on it is
+   a single 6-byte copy from 3 bytes back.
+
+   Format: a series of sequences, each one
+     token      high 4 bits: literal count, low 4 bits: match length - LZ_MIN_MATCH (15 means "more follows")
+     [varint]   literal count - 15, if the high nibble is 15
+     literals   copied as-is
+     varint     match offset (how far back the copy starts), absent in the final sequence
+     [varint]   match length - LZ_MIN_MATCH - 15, if the low nibble is 15
+   The final sequence has literals only; the decoder knows it is the last one because the input ends.
+
+   Match finder: hash chains.
+   - head[h] holds the latest position whose first 4 bytes hash to h; chain[pos] links to the previous
+     position with the same hash, so walking the chain visits candidates from nearest to farthest.
+   - The walk stops at the window limit or after a number of steps set by the level: level 1 tries a
+     few candidates, level 9 tries hundreds, trading speed for ratio. From level 5 on, the encoder also
+     checks whether starting the match one byte later would give a longer one (lazy matching).
+   - A match is only used when it is shorter to encode than the literals it replaces, which keeps the
+     output within lzCompressBound.
+*/
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 16
+#define LZ_MIN_WINDOW_LOG 10
+#define LZ_MAX_WINDOW_LOG 24
+#define LZ_DEFAULT_WINDOW_LOG 20
+#define LZ_DEFAULT_LEVEL 5
+
+typedef struct {
+    int level;          // 1 (fastest) to 9 (best ratio)
+    int windowLog;      // Matches reach back at most 1 << windowLog bytes
+} LzParams;
+
+size_t lzCompressBound(size_t length) {
+    return length + length / 8 + 16;
+}
+
+static int varintSize(size_t value) {
+    int size = 1;
+    while(value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static inline uint32_t lzHash(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+static size_t matchLength(const unsigned char* a, const unsigned char* b, const unsigned char* end) {
+    const unsigned char* start = b;
+    while(end - b >= 8) {
+        uint64_t x, y;
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        if(x != y) {
+            return b - start + (__builtin_ctzll(x ^ y) >> 3);
+        }
+        a += 8;
+        b += 8;
+    }
+    while(b < end && *a == *b) {
+        a++;
+        b++;
+    }
+    return b - start;
+}
+
+static unsigned char* writeSequence(unsigned char* out, const unsigned char* literals, size_t literalCount,
+                                    size_t offset, size_t length) {
+    size_t matchCode = length ? length - LZ_MIN_MATCH : 0;
+    *out++ = (unsigned char)(((literalCount < 15 ? literalCount : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+    if(literalCount >= 15) {
+        out = writeVarint(out, literalCount - 15);
+    }
+    memcpy(out, literals, literalCount);
+    out += literalCount;
+    if(length) {
+        out = writeVarint(out, offset);
+        if(matchCode >= 15) {
+            out = writeVarint(out, matchCode - 15);
+        }
+    }
+    return out;
+}
+
+typedef struct {
+    int32_t* head;
+    int32_t* chain;
+    size_t chainMask;
+    const unsigned char* base;
+    size_t window;
+    int depth;
+} MatchFinder;
+
+static size_t findMatch(const MatchFinder* mf, size_t pos, const unsigned char* end, size_t* offset) {
+    const unsigned char* p = mf->base + pos;
+    int32_t candidate = mf->head[lzHash(p)];
+    size_t best = 0;
+
+    for(int steps = mf->depth; candidate >= 0 && steps > 0; --steps) {
+        size_t distance = pos - (size_t)candidate;
+        if(distance > mf->window) {
+            break;
+        }
+        const unsigned char* c = mf->base + candidate;
+        // Only a candidate that also matches the byte just past the current best can beat it
+        if(p + best < end && c[best] == p[best]) {
+            size_t length = matchLength(c, p, end);
+            if(length > best) {
+                best = length;
+                *offset = distance;
+                if(p + best == end) {
+                    break;
+                }
+            }
+        }
+        candidate = mf->chain[candidate & mf->chainMask];
+    }
+    return best;
+}
+
+static inline void insertPosition(MatchFinder* mf, size_t pos) {
+    uint32_t h = lzHash(mf->base + pos);
+    mf->chain[pos & mf->chainMask] = mf->head[h];
+    mf->head[h] = (int32_t)pos;
+}
+
+// Compress 'length' bytes of src into dst, which must hold lzCompressBound(length) bytes. Returns the compressed size.
+size_t lzCompress(const unsigned char* src, size_t length, unsigned char* dst, const LzParams* params) {
+    int level = params->level < 1 ? 1 : params->level > 9 ? 9 : params->level;
+    int windowLog = params->windowLog < LZ_MIN_WINDOW_LOG ? LZ_MIN_WINDOW_LOG :
+                    params->windowLog > LZ_MAX_WINDOW_LOG ? LZ_MAX_WINDOW_LOG : params->windowLog;
+    const unsigned char* end = src + length;
+    unsigned char* out = dst;
+
+    // The chain only needs one slot per position that can still be referenced
+    size_t chainSize = 1;
+    while(chainSize < length && chainSize < ((size_t)1 << windowLog)) {
+        chainSize <<= 1;
+    }
+
+    MatchFinder mf;
+    mf.head = malloc(((size_t)1 << LZ_HASH_BITS) * sizeof(int32_t));
+    mf.chain = malloc(chainSize * sizeof(int32_t));
+    if(mf.head == NULL || mf.chain == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    memset(mf.head, 0xFF, ((size_t)1 << LZ_HASH_BITS) * sizeof(int32_t));
+    mf.chainMask = chainSize - 1;
+    mf.base = src;
+    mf.window = chainSize < ((size_t)1 << windowLog) ? chainSize : ((size_t)1 << windowLog) - 1;
+    mf.depth = 1 << (level - 1);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while(length >= LZ_MIN_MATCH && pos <= length - LZ_MIN_MATCH) {
+        size_t offset = 0;
+        size_t best = findMatch(&mf, pos, end, &offset);
+        insertPosition(&mf, pos);
+
+        // Lazy matching: prefer a longer match starting at the next byte
+        if(level >= 5 && best >= LZ_MIN_MATCH && pos + 1 <= length - LZ_MIN_MATCH) {
+            size_t nextOffset = 0;
+            size_t next = findMatch(&mf, pos + 1, end, &nextOffset);
+            if(next > best + 1) {
+                insertPosition(&mf, pos + 1);
+                pos++;
+                best = next;
+                offset = nextOffset;
+            }
+        }
+
+        // Worth it only if the offset costs less than the bytes it replaces
+        if(best < LZ_MIN_MATCH || (size_t)varintSize(offset) + 1 > best) {
+            pos++;
+            continue;
+        }
+
+        out = writeSequence(out, src + anchor, pos - anchor, offset, best);
+        for(size_t i = pos + 1; i < pos + best && i <= length - LZ_MIN_MATCH; ++i) {
+            insertPosition(&mf, i);
+        }
+        pos += best;
+        anchor = pos;
+    }
+
+    if(anchor < length) {
+        out = writeSequence(out, src + anchor, length - anchor, 0, 0);
+    }
+
+    free(mf.head);
+    free(mf.chain);
+    return out - dst;
+}
+
+// Decompress src into dst, which holds dstCapacity bytes. Returns the decompressed size, or RLE_ERROR.
+size_t lzDecompress(const unsigned char* src, size_t length, unsigned char* dst, size_t dstCapacity) {
+    const unsigned char* end = src + length;
+    unsigned char* out = dst;
+    unsigned char* outEnd = dst + dstCapacity;
+
+    while(src < end) {
+        unsigned char token = *src++;
+        size_t literalCount = token >> 4;
+        size_t matchCode = token & 0x0F;
+        size_t extra;
+
+        if(literalCount == 15) {
+            if((src = readVarint(src, end, &extra)) == NULL) return RLE_ERROR;
+            literalCount += extra;
+        }
+        if(literalCount > (size_t)(end - src) || literalCount > (size_t)(outEnd - out)) {
+            return RLE_ERROR;
+        }
+        memcpy(out, src, literalCount);
+        out += literalCount;
+        src += literalCount;
+
+        if(src == end) {
+            break;      // Final sequence: literals only
+        }
+
+        size_t offset;
+        if((src = readVarint(src, end, &offset)) == NULL) return RLE_ERROR;
+        if(matchCode == 15) {
+            if((src = readVarint(src, end, &extra)) == NULL) return RLE_ERROR;
+            matchCode += extra;
+        }
+        size_t matchLen = matchCode + LZ_MIN_MATCH;
+        if(offset == 0 || offset > (size_t)(out - dst) || matchLen > (size_t)(outEnd - out)) {
+            return RLE_ERROR;
+        }
+
+        const unsigned char* from = out - offset;
+        if(offset >= matchLen) {
+            memcpy(out, from, matchLen);
+            out += matchLen;
+        }
+        else {
+            // Overlapping copy, e.g. offset 1 repeats the previous byte
+            for(size_t i = 0; i < matchLen; ++i) {
+                *out++ = *from++;
+            }
+        }
+    }
+
+    return out - dst;
+}
+
+/*
+   Streaming LZ: the same init/feed/flush and pointer-advancing decode calls as the RLE stream.
+   - Input is collected into frames of 1 << windowLog bytes, and each full frame is compressed on its
+     own, so both sides only ever hold one frame and memory use stays fixed.
+   - The stream starts with "LZ" and the window log; each frame is varint(raw size), varint(stored size)
+     and the payload. A frame that doesn't shrink is stored raw (stored size == raw size).
+*/
+#define LZ_FRAME_HEADER_BOUND 20
+
+typedef struct {
+    LzParams params;
+    size_t frameSize;
+    unsigned char* frame;   // Input collected for the current frame
+    size_t pending;         // Bytes in frame
+    int headerWritten;
+} LzEncoder;
+
+void lzEncoderInit(LzEncoder* enc, const LzParams* params) {
+    enc->params = *params;
+    if(enc->params.windowLog < LZ_MIN_WINDOW_LOG) enc->params.windowLog = LZ_MIN_WINDOW_LOG;
+    if(enc->params.windowLog > LZ_MAX_WINDOW_LOG) enc->params.windowLog = LZ_MAX_WINDOW_LOG;
+    enc->frameSize = (size_t)1 << enc->params.windowLog;
+    enc->frame = malloc(enc->frameSize);
+    if(enc->frame == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    enc->pending = 0;
+    enc->headerWritten = 0;
+}
+
+void lzEncoderDestroy(LzEncoder* enc) {
+    free(enc->frame);
+}
+
+// Output space lzEncoderFeed may need for a chunk of 'length' bytes
+size_t lzFeedBound(const LzEncoder* enc, size_t length) {
+    return 3 + (length / enc->frameSize + 1) * (lzCompressBound(enc->frameSize) + LZ_FRAME_HEADER_BOUND);
+}
+
+static unsigned char* emitFrame(LzEncoder* enc, unsigned char* out) {
+    if(!enc->headerWritten) {
+        *out++ = 'L';
+        *out++ = 'Z';
+        *out++ = (unsigned char)enc->params.windowLog;
+        enc->headerWritten = 1;
+    }
+    if(enc->pending == 0) {
+        return out;
+    }
+
+    // Compress past a worst-case header, then move the payload next to the real header
+    unsigned char* payload = out + LZ_FRAME_HEADER_BOUND;
+    size_t size = lzCompress(enc->frame, enc->pending, payload, &enc->params);
+    if(size >= enc->pending) {
+        memcpy(payload, enc->frame, enc->pending);
+        size = enc->pending;
+    }
+    out = writeVarint(out, enc->pending);
+    out = writeVarint(out, size);
+    memmove(out, payload, size);
+    enc->pending = 0;
+    return out + size;
+}
+
+// Compress one chunk into dst, which must hold lzFeedBound(enc, length) bytes. Returns the number of bytes written.
+size_t lzEncoderFeed(LzEncoder* enc, const unsigned char* src, size_t length, unsigned char* dst) {
+    unsigned char* out = dst;
+    while(length > 0) {
+        size_t count = enc->frameSize - enc->pending;
+        if(count > length) {
+            count = length;
+        }
+        memcpy(enc->frame + enc->pending, src, count);
+        enc->pending += count;
+        src += count;
+        length -= count;
+        if(enc->pending == enc->frameSize) {
+            out = emitFrame(enc, out);
+        }
+    }
+    return out - dst;
+}
+
+// Compress whatever is buffered into dst (lzFeedBound(enc, 0) bytes). Returns the number of bytes written.
+size_t lzEncoderFlush(LzEncoder* enc, unsigned char* dst) {
+    return emitFrame(enc, dst) - dst;
+}
+
+typedef struct {
+    int stage;              // 0: stream header, 1: raw size, 2: stored size, 3: payload, 4: draining output
+    unsigned char header[3];
+    size_t headerLength;
+    size_t frameCapacity;
+    size_t value;           // Varint being read
+    int shift;
+    size_t rawSize;
+    size_t storedSize;
+    unsigned char* input;   // Payload of the current frame
+    size_t inputLength;
+    unsigned char* output;  // Decoded frame
+    size_t outputPosition;
+} LzDecoder;
+
+void lzDecoderInit(LzDecoder* dec) {
+    memset(dec, 0, sizeof(*dec));
+}
+
+void lzDecoderDestroy(LzDecoder* dec) {
+    free(dec->input);
+    free(dec->output);
+}
+
+// Returns 0 on success or -1 if the stream is malformed
+int lzDecoderFeed(LzDecoder* dec, const unsigned char** src, const unsigned char* srcEnd,
+                  unsigned char** dst, unsigned char* dstEnd) {
+    const unsigned char* in = *src;
+    unsigned char* out = *dst;
+    int result = 0;
+
+    for(;;) {
+        if(dec->stage == 4) {
+            size_t count = dec->rawSize - dec->outputPosition;
+            if(count > (size_t)(dstEnd - out)) {
+                count = dstEnd - out;
+            }
+            memcpy(out, dec->output + dec->outputPosition, count);
+            out += count;
+            dec->outputPosition += count;
+            if(dec->outputPosition < dec->rawSize) {
+                break;      // Output is full
+            }
+            dec->stage = 1;
+            dec->value = 0;
+            dec->shift = 0;
+        }
+        if(in == srcEnd) {
+            break;
+        }
+
+        if(dec->stage == 0) {
+            dec->header[dec->headerLength++] = *in++;
+            if(dec->headerLength == 3) {
+                if(dec->header[0] != 'L' || dec->header[1] != 'Z' ||
+                   dec->header[2] < LZ_MIN_WINDOW_LOG || dec->header[2] > LZ_MAX_WINDOW_LOG) {
+                    result = -1;
+                    break;
+                }
+                dec->frameCapacity = (size_t)1 << dec->header[2];
+                dec->input = malloc(dec->frameCapacity);
+                dec->output = malloc(dec->frameCapacity);
+                if(dec->input == NULL || dec->output == NULL) {
+                    printf("Memory allocation failed\n");
+                    exit(1);
+                }
+                dec->stage = 1;
+            }
+        }
+        else if(dec->stage == 1 || dec->stage == 2) {
+            unsigned char byte = *in++;
+            if(dec->shift >= 64) {
+                result = -1;
+                break;
+            }
+            dec->value |= (size_t)(byte & 0x7F) << dec->shift;
+            dec->shift += 7;
+            if(byte & 0x80) {
+                continue;
+            }
+            if(dec->stage == 1) {
+                dec->rawSize = dec->value;
+                dec->stage = 2;
+                if(dec->rawSize == 0 || dec->rawSize > dec->frameCapacity) {
+                    result = -1;
+                    break;
+                }
+            }
+            else {
+                dec->storedSize = dec->value;
+                dec->inputLength = 0;
+                dec->stage = 3;
+                if(dec->storedSize == 0 || dec->storedSize > dec->rawSize) {
+                    result = -1;
+                    break;
+                }
+            }
+            dec->value = 0;
+            dec->shift = 0;
+        }
+        else {
+            size_t count = dec->storedSize - dec->inputLength;
+            if(count > (size_t)(srcEnd - in)) {
+                count = srcEnd - in;
+            }
+            memcpy(dec->input + dec->inputLength, in, count);
+            in += count;
+            dec->inputLength += count;
+            if(dec->inputLength == dec->storedSize) {
+                if(dec->storedSize == dec->rawSize) {
+                    memcpy(dec->output, dec->input, dec->rawSize);
+                }
+                else if(lzDecompress(dec->input, dec->storedSize, dec->output, dec->rawSize) != dec->rawSize) {
+                    result = -1;
+                    break;
+                }
+                dec->outputPosition = 0;
+                dec->stage = 4;
+            }
+        }
+    }
+
+    *src = in;
+    *dst = out;
+    return result;
+}
+
+// Whether the stream ended on a frame boundary with everything written out
+int lzDecoderFinished(const LzDecoder* dec) {
+    return dec->stage == 1 && dec->shift == 0;
+}
+
+/*
+   Text mode: "aaabbc" becomes "a3b2c1".
+   - Each run takes 1 + digits(r) characters, at most 2 * r, so 2 * n + 1 characters always suffice.
+   - The count is written with a small digit loop instead of sprintf.
+*/
 char* compressString(char* str) {
+    TRACE_FUNCTION();
 
     // Calculate the length of the original string
-    int originalLength = strlen(str);
+    size_t originalLength = strlen(str);
+    TRACE_BYTES(originalLength);
 
     // Allocate memory for the compressed string
-    char* compressed = malloc((2 * originalLength + 1) * sizeof(char*));
+    char* compressed = malloc((2 * originalLength + 1) * sizeof(char));
     if(compressed == NULL) {
         printf("Memory allocation failed\n");
         return NULL;
     }
 
-    int count = 1;
-    int index = 0;
+    const unsigned char* p = (const unsigned char*)str;
+    const unsigned char* end = p + originalLength;
+    size_t index = 0;
 
-    // Traverse the string and build the compressed version
-    for(int i=0; i<originalLength; ++i) {
-        if(str[i] == str[i+1]) {
-            count++;
-        }
-        else {
-            compressed[index++] = str[i];
-            index += sprintf(&compressed[index], "%d", count);
-            count = 1;
+    // Traverse the string run by run and build the compressed version
+    while(p < end) {
+        size_t count = runLength(p, end);
+        compressed[index++] = (char)*p;
+        p += count;
+
+        char digits[20];
+        int n = 0;
+        do {
+            digits[n++] = (char)('0' + count % 10);
+            count /= 10;
+        } while(count > 0);
+        while(n > 0) {
+            compressed[index++] = digits[--n];
         }
     }
 
     compressed[index] = '\0';
 
     // Compare the lengths of the compressed and original strings
-    if(strlen(compressed) >= originalLength) {
+    if(index >= originalLength) {
         free(compressed);
         return str;
     }
@@ -82,16 +849,725 @@ char* readString() {
 
 }
 
-int main() {
+/*
+   Streaming pipes: ./CompressString -c < input > output, ./CompressString -d < output > input
+   With "-l level" in front (e.g. ./CompressString -l 6 -c), the LZ codec is used instead of RLE.
+   Only fixed-size buffers are used, however long the input is.
+*/
+#define STREAM_CHUNK (64 * 1024)
+
+static int compressStream(FILE* in, FILE* out, const LzParams* lz) {
+    static unsigned char input[STREAM_CHUNK];
+    RleEncoder rle;
+    LzEncoder lzEnc;
+    size_t outputSize = 2 * STREAM_CHUNK + RLE_FLUSH_BOUND;
+
+    if(lz != NULL) {
+        lzEncoderInit(&lzEnc, lz);
+        outputSize = lzFeedBound(&lzEnc, STREAM_CHUNK);
+    }
+    else {
+        rleEncoderInit(&rle);
+    }
+    unsigned char* output = malloc(outputSize);
+    if(output == NULL) {
+        printf("Memory allocation failed\n");
+        return 1;
+    }
+
+    int result = 0;
+    size_t n, written;
+    while(result == 0 && (n = fread(input, 1, sizeof(input), in)) > 0) {
+        written = lz ? lzEncoderFeed(&lzEnc, input, n, output) : rleEncoderFeed(&rle, input, n, output);
+        if(fwrite(output, 1, written, out) != written) {
+            result = 1;
+        }
+    }
+    written = lz ? lzEncoderFlush(&lzEnc, output) : rleEncoderFlush(&rle, output);
+    if(fwrite(output, 1, written, out) != written || ferror(in)) {
+        result = 1;
+    }
+
+    if(lz != NULL) {
+        lzEncoderDestroy(&lzEnc);
+    }
+    free(output);
+    return result;
+}
+
+static int decompressStream(FILE* in, FILE* out, int useLz) {
+    static unsigned char input[STREAM_CHUNK];
+    static unsigned char output[STREAM_CHUNK];
+    RleDecoder rle;
+    LzDecoder lz;
+    rleDecoderInit(&rle);
+    lzDecoderInit(&lz);
+
+    int result = 0;
+    size_t n;
+    while(result == 0 && (n = fread(input, 1, sizeof(input), in)) > 0) {
+        const unsigned char* src = input;
+        int more;
+        do {
+            unsigned char* dst = output;
+            int status = useLz ? lzDecoderFeed(&lz, &src, input + n, &dst, output + sizeof(output))
+                               : rleDecoderFeed(&rle, &src, input + n, &dst, output + sizeof(output));
+            if(status != 0) {
+                fprintf(stderr, "Corrupt input\n");
+                result = 1;
+                break;
+            }
+            if(fwrite(output, 1, dst - output, out) != (size_t)(dst - output)) {
+                result = 1;
+                break;
+            }
+            // The decoder stops early only when the output buffer is full
+            more = dst == output + sizeof(output);
+        } while(src < input + n || more);
+    }
+    if(result == 0 && !(useLz ? lzDecoderFinished(&lz) : rleDecoderFinished(&rle))) {
+        fprintf(stderr, "Truncated input\n");
+        result = 1;
+    }
+    if(ferror(in)) {
+        result = 1;
+    }
+
+    lzDecoderDestroy(&lz);
+    return result;
+}
+
+/*
+   Thread pool: a fixed set of worker threads that run task(ctx, i) for every i of a batch.
+   - Workers take the next index under the lock, so faster threads simply pick up more of the work.
+   - poolRun returns once the whole batch is done, which lets the caller write results in order.
+*/
+typedef struct {
+    pthread_t* threads;
+    int threadCount;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;        // Signalled when a new batch is posted or the pool stops
+    pthread_cond_t finished;    // Signalled when the last task of a batch completes
+    void (*task)(void* ctx, size_t index);
+    void* ctx;
+    size_t next;                // Next index to hand out
+    size_t count;               // Number of tasks in the batch
+    size_t done;                // Number of tasks completed
+    int stop;
+} ThreadPool;
+
+static void* poolWorker(void* arg) {
+    ThreadPool* pool = arg;
+
+    pthread_mutex_lock(&pool->lock);
+    for(;;) {
+        while(pool->next == pool->count && !pool->stop) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if(pool->stop) {
+            break;
+        }
+
+        size_t index = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        pool->task(pool->ctx, index);
+        pthread_mutex_lock(&pool->lock);
+
+        if(++pool->done == pool->count) {
+            pthread_cond_signal(&pool->finished);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool* initPool(int threadCount) {
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if(pool == NULL) {
+        return NULL;
+    }
+    if(threadCount < 1) {
+        threadCount = 1;
+    }
+    pool->threads = malloc(threadCount * sizeof(pthread_t));
+    if(pool->threads == NULL) {
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    for(int i = 0; i < threadCount; ++i) {
+        if(pthread_create(&pool->threads[i], NULL, poolWorker, pool) != 0) {
+            break;
+        }
+        pool->threadCount++;
+    }
+    return pool;
+}
+
+void poolRun(ThreadPool* pool, void (*task)(void* ctx, size_t index), void* ctx, size_t count) {
+    if(count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->next = 0;
+    pool->done = 0;
+    pool->count = count;
+    pthread_cond_broadcast(&pool->wake);
+    while(pool->done < count) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void destroyPool(ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for(int i = 0; i < pool->threadCount; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    pthread_cond_destroy(&pool->finished);
+    free(pool->threads);
+    free(pool);
+}
+
+/*
+   Block container: the input is cut into independent blocks that are compressed on their own, so they
+   can be compressed and decompressed in parallel and any byte range can be read by decoding only the
+   blocks that cover it.
+
+   Layout (all integers little-endian):
+     header   "RLEC", version (1 byte), codec (1 byte), 2 reserved bytes, block size (u32), raw size (u64),
+              4 reserved bytes
+     blocks   the compressed blocks, back to back
+     index    per block: offset in the file (u64), stored size (u32), raw size (u32)
+     trailer  offset of the index (u64), "RLEI"
+   - A block whose compressed form would not be smaller is stored raw; the reader recognises it because its
+     stored size equals its raw size.
+   - The index is written last, so blocks can be written as soon as their batch is done and memory use is
+     bounded by one batch rather than the whole file.
+*/
+#define CONTAINER_VERSION 1
+#define CONTAINER_HEADER_SIZE 24
+#define CONTAINER_TRAILER_SIZE 12
+#define INDEX_ENTRY_SIZE 16
+#define DEFAULT_BLOCK_SIZE (1 << 20)
+#define BLOCKS_PER_THREAD 4     // Blocks handed to each thread per batch
+
+enum { CODEC_RLE = 0, CODEC_LZ = 1 };
+
+typedef struct {
+    uint64_t offset;            // Where the block starts in the container file
+    uint32_t storedSize;        // Bytes the block occupies in the file
+    uint32_t rawSize;           // Bytes the block decompresses to
+} BlockEntry;
+
+typedef struct {
+    int fd;
+    unsigned char codec;
+    size_t blockSize;
+    size_t rawSize;
+    size_t blockCount;
+    BlockEntry* index;
+} Container;
+
+static void put32(unsigned char* p, uint32_t v) {
+    for(int i = 0; i < 4; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static void put64(unsigned char* p, uint64_t v) {
+    for(int i = 0; i < 8; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint32_t get32(const unsigned char* p) {
+    uint32_t v = 0;
+    for(int i = 3; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+static uint64_t get64(const unsigned char* p) {
+    uint64_t v = 0;
+    for(int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+// Compress one block with the given codec. Returns the compressed size.
+static size_t compressBlock(unsigned char codec, const LzParams* lz, const unsigned char* src, size_t length,
+                            unsigned char* dst) {
+    switch(codec) {
+    case CODEC_LZ:
+        return lzCompress(src, length, dst, lz);
+    default:
+        return rleCompress(src, length, dst);
+    }
+}
+
+// Decompress one block. Returns the decompressed size, or RLE_ERROR.
+static size_t decompressBlock(unsigned char codec, const unsigned char* src, size_t length,
+                              unsigned char* dst, size_t dstCapacity) {
+    switch(codec) {
+    case CODEC_LZ:
+        return lzDecompress(src, length, dst, dstCapacity);
+    case CODEC_RLE:
+        return rleDecompress(src, length, dst, dstCapacity);
+    default:
+        return RLE_ERROR;
+    }
+}
+
+// Output space any codec may need for one block
+static size_t blockBound(size_t blockSize) {
+    size_t rle = rleCompressBound(blockSize);
+    size_t lz = lzCompressBound(blockSize);
+    return rle > lz ? rle : lz;
+}
+
+typedef struct {
+    unsigned char codec;
+    LzParams lz;
+    const unsigned char* input;
+    size_t inputSize;
+    size_t blockSize;
+    size_t firstBlock;          // First block of the current batch
+    unsigned char** outputs;    // One output buffer per batch slot
+    size_t* outputSizes;
+} CompressJob;
+
+static void compressTask(void* ctx, size_t slot) {
+    CompressJob* job = ctx;
+    size_t start = (job->firstBlock + slot) * job->blockSize;
+    size_t length = job->inputSize - start < job->blockSize ? job->inputSize - start : job->blockSize;
+
+    size_t size = compressBlock(job->codec, &job->lz, job->input + start, length, job->outputs[slot]);
+    if(size >= length) {
+        memcpy(job->outputs[slot], job->input + start, length);
+        size = length;
+    }
+    job->outputSizes[slot] = size;
+}
+
+// Compress the file at inPath into a block container at outPath. Returns 0 on success.
+int compressFileParallel(const char* inPath, const char* outPath, unsigned char codec, const LzParams* lz,
+                         size_t blockSize, int threadCount) {
+    int fd = open(inPath, O_RDONLY);
+    if(fd < 0) {
+        perror(inPath);
+        return 1;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        perror(inPath);
+        close(fd);
+        return 1;
+    }
+
+    size_t inputSize = (size_t)st.st_size;
+    const unsigned char* input = NULL;
+    if(inputSize > 0) {
+        input = mmap(NULL, inputSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(input == MAP_FAILED) {
+            perror(inPath);
+            close(fd);
+            return 1;
+        }
+    }
+    close(fd);
+
+    FILE* out = fopen(outPath, "wb");
+    if(out == NULL) {
+        perror(outPath);
+        return 1;
+    }
+
+    size_t blockCount = (inputSize + blockSize - 1) / blockSize;
+    ThreadPool* pool = initPool(threadCount);
+    size_t batchSize = (size_t)threadCount * BLOCKS_PER_THREAD;
+    BlockEntry* index = malloc((blockCount + 1) * sizeof(BlockEntry));
+    unsigned char** outputs = calloc(batchSize, sizeof(unsigned char*));
+    size_t* outputSizes = malloc(batchSize * sizeof(size_t));
+    if(pool == NULL || index == NULL || outputs == NULL || outputSizes == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for(size_t i = 0; i < batchSize; ++i) {
+        outputs[i] = malloc(blockBound(blockSize));
+        if(outputs[i] == NULL) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+    }
+
+    unsigned char header[CONTAINER_HEADER_SIZE] = {'R', 'L', 'E', 'C', CONTAINER_VERSION, codec, 0, 0};
+    put32(header + 8, (uint32_t)blockSize);
+    put64(header + 12, inputSize);
+    put32(header + 20, 0);
+    fwrite(header, 1, sizeof(header), out);
+    uint64_t offset = sizeof(header);
+
+    CompressJob job = {codec, *lz, input, inputSize, blockSize, 0, outputs, outputSizes};
+    for(size_t first = 0; first < blockCount; first += batchSize) {
+        size_t count = blockCount - first < batchSize ? blockCount - first : batchSize;
+        job.firstBlock = first;
+        poolRun(pool, compressTask, &job, count);
+
+        // Write the batch in block order
+        for(size_t slot = 0; slot < count; ++slot) {
+            size_t block = first + slot;
+            index[block].offset = offset;
+            index[block].storedSize = (uint32_t)outputSizes[slot];
+            index[block].rawSize = (uint32_t)(inputSize - block * blockSize < blockSize ? inputSize - block * blockSize : blockSize);
+            fwrite(outputs[slot], 1, outputSizes[slot], out);
+            offset += outputSizes[slot];
+        }
+    }
+
+    unsigned char entry[INDEX_ENTRY_SIZE];
+    for(size_t block = 0; block < blockCount; ++block) {
+        put64(entry, index[block].offset);
+        put32(entry + 8, index[block].storedSize);
+        put32(entry + 12, index[block].rawSize);
+        fwrite(entry, 1, sizeof(entry), out);
+    }
+    unsigned char trailer[CONTAINER_TRAILER_SIZE] = {0};
+    put64(trailer, offset);
+    memcpy(trailer + 8, "RLEI", 4);
+    fwrite(trailer, 1, sizeof(trailer), out);
+
+    int result = ferror(out) ? 1 : 0;
+    if(fclose(out) != 0) {
+        result = 1;
+    }
+
+    destroyPool(pool);
+    for(size_t i = 0; i < batchSize; ++i) {
+        free(outputs[i]);
+    }
+    free(outputs);
+    free(outputSizes);
+    free(index);
+    if(input != NULL) {
+        munmap((void*)input, inputSize);
+    }
+    return result;
+}
+
+// Open a container and load its index. Returns 0 on success.
+int openContainer(Container* c, const char* path) {
+    memset(c, 0, sizeof(*c));
+    c->fd = open(path, O_RDONLY);
+    if(c->fd < 0) {
+        perror(path);
+        return 1;
+    }
+
+    unsigned char header[CONTAINER_HEADER_SIZE];
+    unsigned char trailer[CONTAINER_TRAILER_SIZE];
+    struct stat st;
+    if(fstat(c->fd, &st) != 0 || st.st_size < CONTAINER_HEADER_SIZE + CONTAINER_TRAILER_SIZE ||
+       pread(c->fd, header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+       pread(c->fd, trailer, sizeof(trailer), st.st_size - sizeof(trailer)) != (ssize_t)sizeof(trailer) ||
+       memcmp(header, "RLEC", 4) != 0 || header[4] != CONTAINER_VERSION || memcmp(trailer + 8, "RLEI", 4) != 0) {
+        fprintf(stderr, "%s: not a block container\n", path);
+        close(c->fd);
+        return 1;
+    }
+
+    c->codec = header[5];
+    c->blockSize = get32(header + 8);
+    c->rawSize = get64(header + 12);
+    c->blockCount = c->blockSize ? (c->rawSize + c->blockSize - 1) / c->blockSize : 0;
+
+    // The index must fill the file exactly between the blocks and the trailer
+    uint64_t indexOffset = get64(trailer);
+    uint64_t indexEnd = (uint64_t)st.st_size - CONTAINER_TRAILER_SIZE;
+    if(c->blockSize == 0 || indexOffset < CONTAINER_HEADER_SIZE || indexOffset > indexEnd ||
+       (indexEnd - indexOffset) / INDEX_ENTRY_SIZE != c->blockCount || (indexEnd - indexOffset) % INDEX_ENTRY_SIZE != 0) {
+        fprintf(stderr, "%s: corrupt index\n", path);
+        close(c->fd);
+        return 1;
+    }
+
+    size_t indexBytes = c->blockCount * INDEX_ENTRY_SIZE;
+    unsigned char* raw = malloc(indexBytes + 1);
+    c->index = malloc((c->blockCount + 1) * sizeof(BlockEntry));
+    int corrupt = raw == NULL || c->index == NULL ||
+                  pread(c->fd, raw, indexBytes, indexOffset) != (ssize_t)indexBytes;
+
+    /*
+       - The entries are checked once here so readers can trust them: every block but the last holds
+         exactly blockSize raw bytes and the last one the remainder, no block stores more than it holds,
+         and every block lies between the header and the index.
+    */
+    for(size_t block = 0; block < c->blockCount && !corrupt; ++block) {
+        BlockEntry* e = &c->index[block];
+        e->offset = get64(raw + block * INDEX_ENTRY_SIZE);
+        e->storedSize = get32(raw + block * INDEX_ENTRY_SIZE + 8);
+        e->rawSize = get32(raw + block * INDEX_ENTRY_SIZE + 12);
+        size_t expected = block + 1 < c->blockCount ? c->blockSize : c->rawSize - (c->blockCount - 1) * c->blockSize;
+        corrupt = e->rawSize != expected || e->storedSize == 0 || e->storedSize > e->rawSize ||
+                  e->offset < CONTAINER_HEADER_SIZE || e->offset > indexOffset ||
+                  e->storedSize > indexOffset - e->offset;
+    }
+    free(raw);
+    if(corrupt) {
+        fprintf(stderr, "%s: corrupt index\n", path);
+        free(c->index);
+        close(c->fd);
+        return 1;
+    }
+    return 0;
+}
+
+void closeContainer(Container* c) {
+    free(c->index);
+    close(c->fd);
+}
+
+/*
+   Decode one block into dst (at least blockSize bytes), using scratch (at least blockBound(blockSize) bytes)
+   for the stored bytes. Returns 0 on success. Safe to call from several threads at once.
+*/
+int readBlock(const Container* c, size_t block, unsigned char* scratch, unsigned char* dst) {
+    const BlockEntry* e = &c->index[block];
+    if(e->rawSize > c->blockSize || e->storedSize > e->rawSize) {
+        return 1;
+    }
+    if(e->storedSize == e->rawSize) {
+        return pread(c->fd, dst, e->rawSize, e->offset) == (ssize_t)e->rawSize ? 0 : 1;
+    }
+    if(pread(c->fd, scratch, e->storedSize, e->offset) != (ssize_t)e->storedSize) {
+        return 1;
+    }
+    return decompressBlock(c->codec, scratch, e->storedSize, dst, c->blockSize) == e->rawSize ? 0 : 1;
+}
+
+// Copy 'length' bytes starting at raw offset 'offset' into dst, decoding only the blocks that cover them
+size_t readRange(const Container* c, size_t offset, size_t length, unsigned char* dst) {
+    if(offset >= c->rawSize) {
+        return 0;
+    }
+    if(length > c->rawSize - offset) {
+        length = c->rawSize - offset;
+    }
+
+    unsigned char* scratch = malloc(blockBound(c->blockSize));
+    unsigned char* block = malloc(c->blockSize);
+    if(scratch == NULL || block == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+
+    size_t copied = 0;
+    while(copied < length) {
+        size_t position = offset + copied;
+        size_t b = position / c->blockSize;
+        size_t within = position % c->blockSize;
+        if(readBlock(c, b, scratch, block) != 0) {
+            break;
+        }
+        size_t count = c->index[b].rawSize > within ? c->index[b].rawSize - within : 0;
+        if(count == 0) {
+            break;
+        }
+        if(count > length - copied) {
+            count = length - copied;
+        }
+        memcpy(dst + copied, block + within, count);
+        copied += count;
+    }
+
+    free(scratch);
+    free(block);
+    return copied;
+}
+
+typedef struct {
+    const Container* container;
+    size_t firstBlock;
+    unsigned char** scratch;
+    unsigned char** outputs;
+    int* failed;
+} DecompressJob;
+
+static void decompressTask(void* ctx, size_t slot) {
+    DecompressJob* job = ctx;
+    job->failed[slot] = readBlock(job->container, job->firstBlock + slot, job->scratch[slot], job->outputs[slot]);
+}
+
+// Decompress a whole container to outPath, decoding blocks in parallel. Returns 0 on success.
+int decompressFileParallel(const char* inPath, const char* outPath, int threadCount) {
+    Container c;
+    if(openContainer(&c, inPath) != 0) {
+        return 1;
+    }
+    FILE* out = fopen(outPath, "wb");
+    if(out == NULL) {
+        perror(outPath);
+        closeContainer(&c);
+        return 1;
+    }
+
+    ThreadPool* pool = initPool(threadCount);
+    size_t batchSize = (size_t)threadCount * BLOCKS_PER_THREAD;
+    unsigned char** scratch = calloc(batchSize, sizeof(unsigned char*));
+    unsigned char** outputs = calloc(batchSize, sizeof(unsigned char*));
+    int* failed = calloc(batchSize, sizeof(int));
+    if(pool == NULL || scratch == NULL || outputs == NULL || failed == NULL) {
+        printf("Memory allocation failed\n");
+        exit(1);
+    }
+    for(size_t i = 0; i < batchSize; ++i) {
+        scratch[i] = malloc(blockBound(c.blockSize));
+        outputs[i] = malloc(c.blockSize);
+        if(scratch[i] == NULL || outputs[i] == NULL) {
+            printf("Memory allocation failed\n");
+            exit(1);
+        }
+    }
+
+    int result = 0;
+    DecompressJob job = {&c, 0, scratch, outputs, failed};
+    for(size_t first = 0; first < c.blockCount && result == 0; first += batchSize) {
+        size_t count = c.blockCount - first < batchSize ? c.blockCount - first : batchSize;
+        job.firstBlock = first;
+        poolRun(pool, decompressTask, &job, count);
+
+        for(size_t slot = 0; slot < count; ++slot) {
+            if(failed[slot]) {
+                fprintf(stderr, "%s: block %zu is corrupt\n", inPath, first + slot);
+                result = 1;
+                break;
+            }
+            fwrite(outputs[slot], 1, c.index[first + slot].rawSize, out);
+        }
+    }
+    if(ferror(out) || fclose(out) != 0) {
+        result = 1;
+    }
+
+    destroyPool(pool);
+    for(size_t i = 0; i < batchSize; ++i) {
+        free(scratch[i]);
+        free(outputs[i]);
+    }
+    free(scratch);
+    free(outputs);
+    free(failed);
+    closeContainer(&c);
+    return result;
+}
+
+/*
+   Block containers: ./CompressString -pc input container [threads]
+                     ./CompressString -pd container output [threads]
+                     ./CompressString -x container offset length    (writes the range to stdout)
+   "-l level" in front of -c, -d or -pc selects the LZ codec; a container records its codec itself.
+   Build with: gcc -O2 -march=native -pthread CompressString.c
+*/
+int main(int argc, char* argv[]) {
+
+    LzParams lzParams = {LZ_DEFAULT_LEVEL, LZ_DEFAULT_WINDOW_LOG};
+    const LzParams* lz = NULL;
+    if(argc > 2 && strcmp(argv[1], "-l") == 0) {
+        lzParams.level = atoi(argv[2]);
+        lz = &lzParams;
+        argc -= 2;
+        argv += 2;
+    }
+
+    if(argc > 1 && strcmp(argv[1], "-c") == 0) {
+        return compressStream(stdin, stdout, lz);
+    }
+    if(argc > 1 && strcmp(argv[1], "-d") == 0) {
+        return decompressStream(stdin, stdout, lz != NULL);
+    }
+    if(argc > 3 && (strcmp(argv[1], "-pc") == 0 || strcmp(argv[1], "-pd") == 0)) {
+        int threadCount = argc > 4 ? atoi(argv[4]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        if(threadCount < 1) {
+            threadCount = 1;
+        }
+        if(argv[1][2] == 'c') {
+            return compressFileParallel(argv[2], argv[3], lz ? CODEC_LZ : CODEC_RLE, &lzParams,
+                                        DEFAULT_BLOCK_SIZE, threadCount);
+        }
+        return decompressFileParallel(argv[2], argv[3], threadCount);
+    }
+    if(argc > 4 && strcmp(argv[1], "-x") == 0) {
+        Container c;
+        if(openContainer(&c, argv[2]) != 0) {
+            return 1;
+        }
+        size_t offset = strtoull(argv[3], NULL, 10);
+        size_t length = strtoull(argv[4], NULL, 10);
+        if(offset >= c.rawSize) {
+            fprintf(stderr, "%s: offset %zu is past the end (%zu bytes)\n", argv[2], offset, c.rawSize);
+            closeContainer(&c);
+            return 1;
+        }
+        // Clamp before allocating, so the buffer is never larger than the data
+        if(length > c.rawSize - offset) {
+            length = c.rawSize - offset;
+        }
+        unsigned char* range = malloc(length + 1);
+        if(range == NULL) {
+            printf("Memory allocation failed\n");
+            closeContainer(&c);
+            return 1;
+        }
+        size_t copied = readRange(&c, offset, length, range);
+        fwrite(range, 1, copied, stdout);
+        free(range);
+        closeContainer(&c);
+        return 0;
+    }
 
     printf("Enter a string: ");
     char* inputString = readString();
 
+    if(inputString == NULL) {
+        return 1;
+    }
+
     char* compressed = compressString(inputString);
 
     if(compressed != NULL) {
         printf("%s\n", compressed);
+        if(compressed != inputString) {
+            free(compressed);
+        }
+    }
+
+    // Binary mode, with a round trip through the decoder
+    size_t length = strlen(inputString);
+    unsigned char* packed = malloc(rleCompressBound(length) + 1);
+    unsigned char* unpacked = malloc(length + 1);
+    if(packed != NULL && unpacked != NULL) {
+        size_t packedLength = rleCompress((const unsigned char*)inputString, length, packed);
+        size_t unpackedLength = rleDecompress(packed, packedLength, unpacked, length);
+        printf("Binary: %zu -> %zu bytes, round trip %s\n", length, packedLength,
+               (unpackedLength == length && memcmp(unpacked, inputString, length) == 0) ? "ok" : "FAILED");
+    }
+    free(packed);
+
+    // LZ mode, which also catches repeated phrases such as "abcabcabc"
+    packed = malloc(lzCompressBound(length));
+    if(packed != NULL && unpacked != NULL) {
+        size_t packedLength = lzCompress((const unsigned char*)inputString, length, packed, &lzParams);
+        size_t unpackedLength = lzDecompress(packed, packedLength, unpacked, length);
+        printf("LZ: %zu -> %zu bytes, round trip %s\n", length, packedLength,
+               (unpackedLength == length && memcmp(unpacked, inputString, length) == 0) ? "ok" : "FAILED");
     }
+    free(packed);
+    free(unpacked);
 
     free(inputString);
 
@@ -8,8 +8,18 @@ Concepts: Pointers, string parsing, memory manipulation.
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+#include "../Instrumentation/Trace.h"
 
 char* customStrtok(char* str, const char* delimeters) {
+    TRACE_FUNCTION();
     static char* nextToken = NULL;
 
     // If str not NULL, start tokenizing the new string
@@ -23,7 +33,9 @@ char* customStrtok(char* str, const char* delimeters) {
     }
 
     // Skip leading delimeters
-    nextToken += strspn(nextToken, delimeters);
+    size_t skipped = strspn(nextToken, delimeters);
+    nextToken += skipped;
+    TRACE_BYTES(skipped);
 
     // If we've reached the end of the string, return NULL
     if(*nextToken == '\0') {
@@ -32,7 +44,9 @@ char* customStrtok(char* str, const char* delimeters) {
 
     // Find the end of the current token
     char* tokenStart = nextToken;
-    nextToken = tokenStart + strcspn(tokenStart, delimeters);
+    size_t tokenLength = strcspn(tokenStart, delimeters);
+    nextToken = tokenStart + tokenLength;
+    TRACE_BYTES(tokenLength);
 
     // If a delimeter is found, null-terminate the current token
     if(*nextToken != '\0') {
@@ -47,6 +61,282 @@ char* customStrtok(char* str, const char* delimeters) {
     return tokenStart;
 }
 
+// Reentrant variant: finds the next token at *cursor without modifying the string; returns NULL at the end
+const char* nextTokenSpan(const char** cursor, const char* delimeters, size_t* length) {
+    const char* start = *cursor + strspn(*cursor, delimeters);
+    if(*start == '\0') {
+        *cursor = start;
+        return NULL;
+    }
+    *length = strcspn(start, delimeters);
+    *cursor = start + *length;
+    return start;
+}
+
+/*
+   Interning: log lines repeat the same few thousand tokens millions of times. The intern table keeps
+   one canonical copy of every distinct token and gives it a small integer id, so tokens can be stored
+   as 4-byte ids and compared with ==.
+   - The canonical copies are packed one after another into large arena blocks that never move, so a
+     returned string stays valid until the table is destroyed, and thousands of tokens cost a few
+     allocations instead of one each.
+   - Ids index a two-level array of entries (pages of INTERN_PAGE entries), which also never moves.
+   - The hash table is an open-addressing array of 64-bit slots holding the 32-bit hash and id + 1
+     (0 means empty). Probes compare the whole hash first, so memcmp runs only on real candidates.
+*/
+#define INTERN_PAGE 4096
+#define INTERN_MAX_PAGES 4096           // Up to 16M distinct tokens
+#define INTERN_ARENA_BLOCK (1 << 16)
+
+typedef struct {
+    const char* text;                   // Canonical copy, null-terminated
+    uint32_t length;
+} InternEntry;
+
+typedef struct InternSlots {
+    _Atomic uint64_t* slots;
+    size_t capacity;                    // Always a power of two
+    struct InternSlots* retired;        // Older, smaller tables; freed when the table is destroyed
+} InternSlots;
+
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used;
+    size_t size;
+    char data[];
+} ArenaBlock;
+
+typedef struct {
+    _Atomic(InternSlots*) table;
+    InternEntry* _Atomic pages[INTERN_MAX_PAGES];
+    _Atomic uint32_t count;             // Number of distinct tokens, which is also the next id
+    ArenaBlock* arena;
+    size_t arenaBytes;
+    int concurrent;
+    pthread_mutex_t lock;               // Serializes inserts when concurrent is set
+} InternTable;
+
+/*
+   - With SSE4.2 the hash runs the CPU's CRC32 instruction over 8 bytes per step, which takes about
+     one cycle per word; otherwise a multiply-and-shift mix does the same job in software.
+*/
+static uint32_t hashToken(const char* text, size_t length) {
+    uint64_t h = length;
+#if defined(__SSE4_2__)
+    while(length >= 8) {
+        uint64_t word;
+        memcpy(&word, text, 8);
+        h = _mm_crc32_u64(h, word);
+        text += 8;
+        length -= 8;
+    }
+    if(length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, text, length);
+        h = _mm_crc32_u64(h, word);
+    }
+    // CRC spreads poorly into the high bits of the index; one multiply fixes that
+    return (uint32_t)((h * 0x9E3779B97F4A7C15ull) >> 32);
+#else
+    h ^= 0x9E3779B97F4A7C15ull;
+    while(length >= 8) {
+        uint64_t word;
+        memcpy(&word, text, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+        text += 8;
+        length -= 8;
+    }
+    if(length > 0) {
+        uint64_t word = 0;
+        memcpy(&word, text, length);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+    }
+    return (uint32_t)((h * 0x94D049BB133111EBull) >> 32);
+#endif
+}
+
+static InternSlots* newSlots(size_t capacity, InternSlots* retired) {
+    InternSlots* table = malloc(sizeof(InternSlots));
+    _Atomic uint64_t* slots = calloc(capacity, sizeof(uint64_t));
+    if(table == NULL || slots == NULL) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    table->slots = slots;
+    table->capacity = capacity;
+    table->retired = retired;
+    return table;
+}
+
+// A 'concurrent' table can be shared by several tokenizer threads
+InternTable* createInternTable(int concurrent) {
+    InternTable* t = calloc(1, sizeof(InternTable));
+    if(t == NULL) {
+        printf("Memory allocation failed!\n");
+        exit(1);
+    }
+    atomic_init(&t->table, newSlots(1024, NULL));
+    t->concurrent = concurrent;
+    pthread_mutex_init(&t->lock, NULL);
+    return t;
+}
+
+static const InternEntry* entryOf(InternTable* t, uint32_t id) {
+    InternEntry* page = atomic_load_explicit(&t->pages[id / INTERN_PAGE], memory_order_acquire);
+    return &page[id % INTERN_PAGE];
+}
+
+// Id of the token, or UINT32_MAX if it is not in this table; never writes, safe to run in parallel
+static uint32_t findToken(InternTable* t, const InternSlots* table, const char* text, size_t length, uint32_t hash) {
+    size_t mask = table->capacity - 1;
+    for(size_t i = hash & mask;; i = (i + 1) & mask) {
+        uint64_t slot = atomic_load_explicit(&table->slots[i], memory_order_acquire);
+        if(slot == 0) {
+            return UINT32_MAX;
+        }
+        if((uint32_t)(slot >> 32) == hash) {
+            uint32_t id = (uint32_t)slot - 1;
+            const InternEntry* entry = entryOf(t, id);
+            if(entry->length == length && memcmp(entry->text, text, length) == 0) {
+                return id;
+            }
+        }
+    }
+}
+
+static const char* arenaCopy(InternTable* t, const char* text, size_t length) {
+    if(t->arena == NULL || t->arena->size - t->arena->used < length + 1) {
+        size_t size = length + 1 > INTERN_ARENA_BLOCK ? length + 1 : INTERN_ARENA_BLOCK;
+        ArenaBlock* block = malloc(sizeof(ArenaBlock) + size);
+        if(block == NULL) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        block->next = t->arena;
+        block->used = 0;
+        block->size = size;
+        t->arena = block;
+        t->arenaBytes += size;
+    }
+    char* copy = t->arena->data + t->arena->used;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    t->arena->used += length + 1;
+    return copy;
+}
+
+// Called with the lock held: add a token that is not in the table yet
+static uint32_t insertToken(InternTable* t, const char* text, size_t length, uint32_t hash) {
+    InternSlots* table = atomic_load_explicit(&t->table, memory_order_relaxed);
+    uint32_t id = atomic_load_explicit(&t->count, memory_order_relaxed);
+    if(id / INTERN_PAGE >= INTERN_MAX_PAGES) {
+        printf("Too many distinct tokens!\n");
+        exit(1);
+    }
+
+    // Grow at half full; readers still probing the old array just miss and retry under the lock
+    if((size_t)(id + 1) * 2 > table->capacity) {
+        InternSlots* bigger = newSlots(table->capacity * 2, table);
+        size_t mask = bigger->capacity - 1;
+        for(size_t i = 0; i < table->capacity; ++i) {
+            uint64_t slot = atomic_load_explicit(&table->slots[i], memory_order_relaxed);
+            if(slot != 0) {
+                size_t j = (slot >> 32) & mask;
+                while(atomic_load_explicit(&bigger->slots[j], memory_order_relaxed) != 0) {
+                    j = (j + 1) & mask;
+                }
+                atomic_store_explicit(&bigger->slots[j], slot, memory_order_relaxed);
+            }
+        }
+        atomic_store_explicit(&t->table, bigger, memory_order_release);
+        table = bigger;
+    }
+
+    // Fill in the entry before publishing the slot that points to it
+    InternEntry* page = atomic_load_explicit(&t->pages[id / INTERN_PAGE], memory_order_relaxed);
+    if(page == NULL) {
+        page = malloc(INTERN_PAGE * sizeof(InternEntry));
+        if(page == NULL) {
+            printf("Memory allocation failed!\n");
+            exit(1);
+        }
+        atomic_store_explicit(&t->pages[id / INTERN_PAGE], page, memory_order_release);
+    }
+    page[id % INTERN_PAGE].text = arenaCopy(t, text, length);
+    page[id % INTERN_PAGE].length = (uint32_t)length;
+
+    size_t mask = table->capacity - 1;
+    size_t i = hash & mask;
+    while(atomic_load_explicit(&table->slots[i], memory_order_relaxed) != 0) {
+        i = (i + 1) & mask;
+    }
+    atomic_store_explicit(&table->slots[i], (uint64_t)hash << 32 | (id + 1), memory_order_release);
+    atomic_store_explicit(&t->count, id + 1, memory_order_release);
+    return id;
+}
+
+/*
+   - Returns the id of the token, adding it on first sight. Ids count up from 0.
+   - On a concurrent table the lookup of a known token takes no lock at all; only a token that is not
+     found takes the lock, checks again (another thread may have just added it) and inserts it.
+*/
+uint32_t internToken(InternTable* t, const char* text, size_t length) {
+    uint32_t hash = hashToken(text, length);
+    InternSlots* table = atomic_load_explicit(&t->table, memory_order_acquire);
+    uint32_t id = findToken(t, table, text, length, hash);
+    if(id != UINT32_MAX) {
+        return id;
+    }
+
+    if(t->concurrent) {
+        pthread_mutex_lock(&t->lock);
+        table = atomic_load_explicit(&t->table, memory_order_relaxed);
+        id = findToken(t, table, text, length, hash);
+    }
+    if(id == UINT32_MAX) {
+        id = insertToken(t, text, length, hash);
+    }
+    if(t->concurrent) {
+        pthread_mutex_unlock(&t->lock);
+    }
+    return id;
+}
+
+// The canonical copy of token 'id'
+const char* internedString(InternTable* t, uint32_t id, size_t* length) {
+    const InternEntry* entry = entryOf(t, id);
+    if(length != NULL) {
+        *length = entry->length;
+    }
+    return entry->text;
+}
+
+uint32_t internCount(InternTable* t) {
+    return atomic_load_explicit(&t->count, memory_order_acquire);
+}
+
+void destroyInternTable(InternTable* t) {
+    InternSlots* table = atomic_load(&t->table);
+    while(table != NULL) {
+        InternSlots* older = table->retired;
+        free((void*)table->slots);
+        free(table);
+        table = older;
+    }
+    for(size_t i = 0; i < INTERN_MAX_PAGES && t->pages[i] != NULL; ++i) {
+        free(t->pages[i]);
+    }
+    while(t->arena != NULL) {
+        ArenaBlock* next = t->arena->next;
+        free(t->arena);
+        t->arena = next;
+    }
+    pthread_mutex_destroy(&t->lock);
+    free(t);
+}
+
 // Function to read the input from user
 char* readString() {
     int bufferSize = 10;
@@ -81,19 +371,118 @@ char* readString() {
 
 }
 
-int main() {
+/*
+   Benchmark: ./CustomStringTokenizer bench [threads] [lines]
+   - Builds synthetic log lines from a vocabulary of a few thousand words, then tokenizes and interns
+     them on several threads sharing one table, and compares the bytes of all tokens seen with the
+     bytes the table actually keeps.
+*/
+typedef struct {
+    InternTable* table;
+    const char* const* lines;
+    size_t from;
+    size_t to;
+    size_t tokens;
+    size_t tokenBytes;
+    uint64_t checksum;
+} InternJob;
+
+static void* internWorker(void* arg) {
+    InternJob* job = arg;
+    for(size_t i = job->from; i < job->to; ++i) {
+        const char* cursor = job->lines[i];
+        const char* token;
+        size_t length;
+        while((token = nextTokenSpan(&cursor, " ,.!=", &length)) != NULL) {
+            job->checksum += internToken(job->table, token, length);
+            job->tokens++;
+            job->tokenBytes += length + 1;
+        }
+    }
+    return NULL;
+}
+
+static int runBenchmark(int threads, size_t lines) {
+    const size_t vocabulary = 4000;
+    const size_t lineLength = 120;
+    char** text = malloc(lines * sizeof(char*));
+    char* storage = malloc(lines * lineLength);
+    if(text == NULL || storage == NULL) {
+        printf("Memory allocation failed!\n");
+        return 1;
+    }
+    uint32_t state = 2463534242u;
+    for(size_t i = 0; i < lines; ++i) {
+        char* line = storage + i * lineLength;
+        size_t used = 0;
+        while(used + 24 < lineLength) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            used += sprintf(line + used, "w%zu_%s ", (size_t)(state % vocabulary), (state & 64) ? "status" : "request");
+        }
+        text[i] = line;
+    }
+
+    InternTable* table = createInternTable(threads > 1);
+    InternJob* jobs = calloc(threads, sizeof(InternJob));
+    pthread_t* ids = malloc(threads * sizeof(pthread_t));
+    if(jobs == NULL || ids == NULL) {
+        printf("Memory allocation failed!\n");
+        return 1;
+    }
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for(int i = 0; i < threads; ++i) {
+        jobs[i] = (InternJob){table, (const char* const*)text, lines * i / threads, lines * (i + 1) / threads, 0, 0, 0};
+        pthread_create(&ids[i], NULL, internWorker, &jobs[i]);
+    }
+    size_t tokens = 0;
+    size_t tokenBytes = 0;
+    for(int i = 0; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+        tokens += jobs[i].tokens;
+        tokenBytes += jobs[i].tokenBytes;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+
+    printf("%zu tokens on %d threads in %.3fs (%.1f M tokens/s)\n", tokens, threads, seconds, tokens / seconds / 1e6);
+    printf("%u distinct tokens; %zu bytes of token copies vs %zu bytes of arena\n", internCount(table),
+           tokenBytes, table->arenaBytes);
+
+    destroyInternTable(table);
+    free(jobs);
+    free(ids);
+    free(storage);
+    free(text);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        int threads = argc > 2 ? atoi(argv[2]) : 4;
+        size_t lines = argc > 3 ? strtoull(argv[3], NULL, 10) : 1000000;
+        return runBenchmark(threads > 0 ? threads : 1, lines);
+    }
 
     printf("Enter a string: ");
     char* inputString = readString();
     const char* delimeters = " ,.!";
 
+    // Intern every token: repeated tokens get the same id and share one stored copy
+    InternTable* table = createInternTable(0);
     char* token = customStrtok(inputString, delimeters);
 
     while(token != NULL) {
-        printf("Token: %s\n", token);
+        uint32_t id = internToken(table, token, strlen(token));
+        printf("Token: %s (id %u)\n", token, id);
         token = customStrtok(NULL, delimeters);
     }
+    printf("%u distinct tokens\n", internCount(table));
 
+    destroyInternTable(table);
     free(inputString);
 
     return 0;
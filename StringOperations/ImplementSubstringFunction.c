@@ -7,6 +7,9 @@ Concepts: Pointers, string manipulation, dynamic memory allocation.
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+
+#include "Utf8.h"
 
 // Function to read the input from user
 char* readString() {
@@ -67,7 +70,85 @@ char* substring(char* str, int start, int substrLength, int originalStrLength) {
     return substr;
 }
 
-int main() {
+/*
+   UTF-8: substring above counts bytes, so it can cut a multi-byte character in half. The functions
+   below count by code point instead, using the validation and counting layer of Utf8.h.
+*/
+// Like substring, but 'start' and 'substrLength' count code points of a UTF-8 string
+char* substringUtf8(const char* str, size_t len, size_t start, size_t substrLength) {
+    if(!utf8Validate(str, len)) {
+        printf("Invalid UTF-8 input!!\n");
+        return NULL;
+    }
+    size_t from = utf8Offset(str, len, start);
+    if(from >= len || substrLength == 0) {
+        printf("Out of range input!!\n");
+        return NULL;
+    }
+    size_t to = from + utf8Offset(str + from, len - from, substrLength);
+
+    char* substr = malloc(to - from + 1);
+    if(substr == NULL) {
+        printf("Memory allocation failed!!\n");
+        return NULL;
+    }
+    memcpy(substr, str + from, to - from);
+    substr[to - from] = '\0';
+    return substr;
+}
+
+/*
+   Benchmark: ./ImplementSubstringFunction bench
+   - Validates 64 MB of ASCII and of mixed ASCII, 2-, 3- and 4-byte text, and reports GB/s against the
+     byte-at-a-time validator.
+*/
+static double timeValidation(int (*validate)(const char*, size_t), const char* text, size_t len, int* valid) {
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for(int i = 0; i < 5; ++i) {
+        *valid = validate(text, len);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+    return 5.0 * len / seconds / 1e9;
+}
+
+static int validateScalar(const char* str, size_t len) {
+    return utf8ValidateScalar((const unsigned char*)str, len);
+}
+
+static int runBenchmark(void) {
+    const size_t len = 64 << 20;
+    char* text = malloc(len);
+    if(text == NULL) {
+        printf("Memory allocation failed!!\n");
+        return 1;
+    }
+    const char* samples[] = {"plain ascii text ", "h\xC3\xA9llo w\xC3\xB6rld \xE2\x9C\x93 \xF0\x9F\x98\x80 "};
+    const char* labels[] = {"ascii", "mixed"};
+
+    for(int s = 0; s < 2; ++s) {
+        size_t sampleLength = strlen(samples[s]);
+        size_t filled = 0;
+        while(filled + sampleLength <= len) {
+            memcpy(text + filled, samples[s], sampleLength);
+            filled += sampleLength;
+        }
+        int fast, slow;
+        double fastRate = timeValidation(utf8Validate, text, filled, &fast);
+        double slowRate = timeValidation(validateScalar, text, filled, &slow);
+        printf("%-6s utf8Validate %6.2f GB/s, scalar %6.2f GB/s, %zu code points%s\n", labels[s], fastRate,
+               slowRate, utf8Length(text, filled), fast && slow ? "" : " (INVALID)");
+    }
+    free(text);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchmark();
+    }
+
     printf("Enter a string: ");
     char* inputString = readString();
 
@@ -100,6 +181,16 @@ int main() {
             free(substr);
         }
 
+        // The same range counted in characters rather than bytes, for UTF-8 input
+        if(start >= 0 && substrLength > 0) {
+            printf("Length in code points: %zu\n", utf8Length(inputString, length));
+            char* chars = substringUtf8(inputString, length, start, substrLength);
+            if(chars != NULL) {
+                printf("Code point substring starting from %d with the length of %d is: %s\n", start, substrLength, chars);
+                free(chars);
+            }
+        }
+
         free(inputString);  // No need to check if inputString is NULL, free(NULL) is safe
     }
 
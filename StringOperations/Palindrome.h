@@ -0,0 +1,191 @@
+#ifndef PALINDROME_H
+#define PALINDROME_H
+
+#include <stddef.h>
+#include <string.h>
+#include <ctype.h>
+
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
+/*
+   Palindrome check shared by PalindromeChecker.c, PalindromeChecker1.c and PalindromeChecker2.c.
+   Everything is static, so each program that includes it gets its own copy of the tables and the code.
+   - The check runs directly on the caller's string, no normalized copy is allocated.
+   - lowerAlnum[] maps every byte to its lowercase form if it is alphanumeric and to 0 otherwise.
+   - packIndex[mask] lists the positions of the set bits of an 8-bit mask. It is used to squeeze the
+     alphanumeric bytes of a block together with a single shuffle (table-driven compaction).
+   - Blocks of 16 bytes are taken from both ends. The block from the back is byte-reversed before it is
+     compacted, so both queues hold characters in the order the two-pointer walk would visit them and
+     can be compared 16 bytes at a time.
+*/
+static unsigned char lowerAlnum[256];
+static unsigned char packIndex[256][8];
+
+__attribute__((constructor))
+static void initPalindromeTables(void) {
+    for(int c = 0; c < 256; ++c) {
+        lowerAlnum[c] = isalnum(c) ? (unsigned char)tolower(c) : 0;
+    }
+
+    for(int mask = 0; mask < 256; ++mask) {
+        int count = 0;
+        for(int bit = 0; bit < 8; ++bit) {
+            if(mask & (1 << bit)) {
+                packIndex[mask][count++] = (unsigned char)bit;
+            }
+        }
+        // Unused slots point at the last byte, the caller only keeps the first 'count' bytes
+        while(count < 8) {
+            packIndex[mask][count++] = 7;
+        }
+    }
+}
+
+#if defined(__SSSE3__)
+// Lowercase a block and return the bitmask of its alphanumeric bytes
+static inline __m128i lowerBlock(__m128i block, unsigned* mask) {
+    __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+    __m128i digit = _mm_sub_epi8(block, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(lower, _mm_set1_epi8('a'));
+
+    digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(25)), letter);
+
+    *mask = (unsigned)_mm_movemask_epi8(_mm_or_si128(digit, letter));
+    return lower;
+}
+
+// Append the alphanumeric bytes of a block to dest, return how many were written
+static inline int compactBlock(__m128i block, unsigned char* dest) {
+    unsigned mask;
+    __m128i lower = lowerBlock(block, &mask);
+
+    unsigned lowMask = mask & 0xFF;
+    unsigned highMask = mask >> 8;
+    __m128i index = _mm_unpacklo_epi64(
+        _mm_loadl_epi64((const __m128i*)packIndex[lowMask]),
+        _mm_add_epi8(_mm_loadl_epi64((const __m128i*)packIndex[highMask]), _mm_set1_epi8(8)));
+    __m128i packed = _mm_shuffle_epi8(lower, index);
+
+    int lowCount = __builtin_popcount(lowMask);
+    _mm_storel_epi64((__m128i*)dest, packed);
+    _mm_storel_epi64((__m128i*)(dest + lowCount), _mm_srli_si128(packed, 8));
+
+    return lowCount + __builtin_popcount(highMask);
+}
+
+#if defined(__AVX2__)
+static inline __m256i lowerBlock32(__m256i block, unsigned* mask) {
+    __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+    __m256i digit = _mm256_sub_epi8(block, _mm256_set1_epi8('0'));
+    __m256i letter = _mm256_sub_epi8(lower, _mm256_set1_epi8('a'));
+
+    digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(25)), letter);
+
+    *mask = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(digit, letter));
+    return lower;
+}
+#endif
+#endif
+
+// Check whether the first 'length' bytes of str form a palindrome, ignoring case and non-alphanumerics
+static inline int isPalindromeLength(const char* str, size_t length) {
+    const unsigned char* left = (const unsigned char*)str;
+    const unsigned char* right = left + length;
+
+#if defined(__SSSE3__)
+    // Pending characters from each end; 16 bytes of slack for the 8-byte stores in compactBlock
+    unsigned char front[48];
+    unsigned char back[48];
+    int frontCount = 0;
+    int backCount = 0;
+    const __m128i reverse16 = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+
+    while(right - left >= 16) {
+#if defined(__AVX2__)
+        // Fast path: nothing pending and both 32-byte blocks are entirely alphanumeric
+        if(frontCount == 0 && backCount == 0 && right - left >= 64) {
+            unsigned frontMask, backMask;
+            __m256i head = lowerBlock32(_mm256_loadu_si256((const __m256i*)left), &frontMask);
+            __m256i tail = lowerBlock32(_mm256_loadu_si256((const __m256i*)(right - 32)), &backMask);
+
+            if((frontMask & backMask) == 0xFFFFFFFFu) {
+                tail = _mm256_shuffle_epi8(tail, _mm256_broadcastsi128_si256(reverse16));
+                tail = _mm256_permute4x64_epi64(tail, 0x4E);
+                if((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(head, tail)) != 0xFFFFFFFFu) {
+                    return 0;
+                }
+                left += 32;
+                right -= 32;
+                continue;
+            }
+        }
+#endif
+        // Refill whichever side has fewer pending characters, so neither queue grows past 31
+        if(frontCount <= backCount) {
+            frontCount += compactBlock(_mm_loadu_si128((const __m128i*)left), front + frontCount);
+            left += 16;
+        }
+        else {
+            right -= 16;
+            __m128i block = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)right), reverse16);
+            backCount += compactBlock(block, back + backCount);
+        }
+
+        if(frontCount >= 16 && backCount >= 16) {
+            __m128i a = _mm_loadu_si128((const __m128i*)front);
+            __m128i b = _mm_loadu_si128((const __m128i*)back);
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF) {
+                return 0;
+            }
+            frontCount -= 16;
+            backCount -= 16;
+            memmove(front, front + 16, frontCount);
+            memmove(back, back + 16, backCount);
+        }
+    }
+
+    // Whatever is left (pending front, unread middle, pending back) fits in a small stack buffer
+    unsigned char rest[96];
+    int restLength = 0;
+
+    memcpy(rest, front, frontCount);
+    restLength = frontCount;
+    for(const unsigned char* p = left; p < right; ++p) {
+        if(lowerAlnum[*p]) {
+            rest[restLength++] = lowerAlnum[*p];
+        }
+    }
+    for(int i = backCount - 1; i >= 0; --i) {
+        rest[restLength++] = back[i];
+    }
+
+    for(int i = 0, j = restLength - 1; i < j; ++i, --j) {
+        if(rest[i] != rest[j]) {
+            return 0;
+        }
+    }
+    return 1;
+#else
+    // Scalar two-pointer walk over the lookup table
+    while(left < right) {
+        while(left < right && !lowerAlnum[*left]) left++;
+        while(left < right && !lowerAlnum[right[-1]]) right--;
+
+        if(left >= right) {
+            break;
+        }
+        if(lowerAlnum[*left] != lowerAlnum[right[-1]]) {
+            return 0;
+        }
+        left++;
+        right--;
+    }
+    return 1;
+#endif
+}
+
+#endif
@@ -2,42 +2,94 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Palindrome.h"
 
 // Function to check if a string is a palindrome
 int isPalindrome(char* inputString) {
-    int length = strlen(inputString);
+    return isPalindromeLength(inputString, strlen(inputString));
+}
 
-    // Allocate memory for a cleaned version of the string
-    char* str = malloc((length + 1) * sizeof(char));
-    if (str == NULL) {
-        printf("Memory allocation failed!\n");
-        return 0;
+/*
+   - Manacher's algorithm: finds the longest palindromic substring in O(n).
+   - odd[i] is the radius of the longest odd-length palindrome centred on i, even[i] of the longest
+     even-length palindrome whose right half starts at i.
+   - Each centre reuses the radius of its mirror inside the rightmost palindrome found so far, so the
+     right boundary only ever moves forward and the total work is linear.
+   - The match is exact (bytes are compared as-is), unlike isPalindrome which ignores case and punctuation.
+   - 'work' must have room for 2 * length entries; it lets callers reuse one buffer across many strings.
+*/
+size_t longestPalindromeWork(const char* str, size_t length, size_t* start, size_t* work) {
+    size_t* odd = work;
+    size_t* even = work + length;
+    size_t bestStart = 0;
+    size_t bestLength = length > 0 ? 1 : 0;
+
+    // Odd-length palindromes
+    for(size_t i = 0, left = 0, right = 0; i < length; ++i) {
+        size_t k = 1;
+        if(i < right) {
+            size_t mirror = odd[left + right - 1 - i];
+            k = mirror < right - i ? mirror : right - i;
+        }
+        while(k <= i && i + k < length && str[i - k] == str[i + k]) {
+            k++;
+        }
+        odd[i] = k;
+        if(i + k > right) {
+            left = i - k + 1;
+            right = i + k;
+        }
+        if(2 * k - 1 > bestLength) {
+            bestLength = 2 * k - 1;
+            bestStart = i - k + 1;
+        }
     }
 
-    int index = 0;
-    // Normalize the input string: remove non-alphanumeric characters and convert to lowercase
-    for (int i = 0; i < length; ++i) {
-        if (isalnum((unsigned char)inputString[i])) {  // Use inputString here
-            str[index++] = tolower((unsigned char)inputString[i]);
+    // Even-length palindromes
+    for(size_t i = 0, left = 0, right = 0; i < length; ++i) {
+        size_t k = 0;
+        if(i < right) {
+            size_t mirror = even[left + right - i];
+            k = mirror < right - i ? mirror : right - i;
+        }
+        while(k < i && i + k < length && str[i - k - 1] == str[i + k]) {
+            k++;
+        }
+        even[i] = k;
+        if(i + k > right) {
+            left = i - k;
+            right = i + k;
+        }
+        if(2 * k > bestLength) {
+            bestLength = 2 * k;
+            bestStart = i - k;
         }
     }
-    str[index] = '\0';  // Null-terminate the cleaned string
 
-    // Check for palindrome using two-pointer technique
-    int left = 0;
-    int right = index - 1;
+    if(start != NULL) {
+        *start = bestStart;
+    }
+    return bestLength;
+}
 
-    while (left < right) {
-        if (str[left] != str[right]) {
-            free(str);  // Free the allocated memory
-            return 0;   // Not a palindrome
-        }
-        left++;
-        right--;
+// Function to find the longest palindromic substring, returns its length and stores its offset in *start
+size_t longestPalindrome(const char* str, size_t length, size_t* start) {
+    size_t* work = malloc((2 * length + 1) * sizeof(size_t));
+    if(work == NULL) {
+        printf("Memory allocation failed!\n");
+        return 0;
     }
 
-    free(str);  // Free the allocated memory
-    return 1;   // It's a palindrome
+    size_t result = longestPalindromeWork(str, length, start, work);
+    free(work);
+    return result;
 }
 
 // Function to read the input from the user
@@ -72,7 +124,170 @@ char* readString() {
     return actualBuffer;
 }
 
-int main() {
+/*
+   Batch mode: ./PalindromeChecker <file> [threads]
+   - The file is mapped read-only and split into lines; the lines are divided into contiguous ranges,
+     one per thread.
+   - Every thread checks its lines with isPalindromeLength and longestPalindromeWork, reusing a single
+     scratch buffer, and writes into its slice of a shared result array, so no locking is needed.
+   - Results are printed in line order as "line<TAB>palindrome<TAB>start<TAB>length"; the throughput
+     summary goes to stderr.
+   Build with: gcc -O2 -march=native -pthread PalindromeChecker.c
+*/
+typedef struct {
+    unsigned char palindrome;   // 1 if the whole line is a palindrome
+    size_t longestStart;        // Offset of the longest palindromic substring within the line
+    size_t longestLength;       // Length of the longest palindromic substring
+} LineResult;
+
+typedef struct {
+    const char* text;           // Mapped file contents
+    const size_t* lineStart;    // Offset of each line, lineStart[lineCount] is one past the end
+    LineResult* results;
+    size_t firstLine;
+    size_t lastLine;            // One past the last line handled by this thread
+} BatchJob;
+
+static void* runBatchJob(void* arg) {
+    BatchJob* job = arg;
+    size_t* work = NULL;
+    size_t workCapacity = 0;
+
+    for(size_t line = job->firstLine; line < job->lastLine; ++line) {
+        const char* str = job->text + job->lineStart[line];
+        size_t length = job->lineStart[line + 1] - job->lineStart[line];
+
+        // Drop the line terminator
+        if(length > 0 && str[length - 1] == '\n') length--;
+        if(length > 0 && str[length - 1] == '\r') length--;
+
+        if(2 * length > workCapacity) {
+            free(work);
+            workCapacity = 2 * length + 256;
+            work = malloc(workCapacity * sizeof(size_t));
+            if(work == NULL) {
+                fprintf(stderr, "Memory allocation failed!\n");
+                exit(1);
+            }
+        }
+
+        LineResult* result = &job->results[line];
+        result->palindrome = (unsigned char)isPalindromeLength(str, length);
+        result->longestLength = longestPalindromeWork(str, length, &result->longestStart, work);
+    }
+
+    free(work);
+    return NULL;
+}
+
+static int runBatch(const char* path, int threadCount) {
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        perror(path);
+        return 1;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return 1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char* text = "";
+    if(size > 0) {
+        text = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(text == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return 1;
+        }
+        madvise((void*)text, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    // Index the line starts
+    size_t lineCount = 0;
+    for(const char* p = text; p < text + size; ++lineCount) {
+        const char* newline = memchr(p, '\n', text + size - p);
+        p = newline ? newline + 1 : text + size;
+    }
+
+    size_t* lineStart = malloc((lineCount + 1) * sizeof(size_t));
+    LineResult* results = malloc((lineCount + 1) * sizeof(LineResult));
+    if(lineStart == NULL || results == NULL) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    size_t line = 0;
+    for(const char* p = text; p < text + size; ++line) {
+        lineStart[line] = p - text;
+        const char* newline = memchr(p, '\n', text + size - p);
+        p = newline ? newline + 1 : text + size;
+    }
+    lineStart[lineCount] = size;
+
+    if(threadCount < 1) {
+        threadCount = 1;
+    }
+    pthread_t* threads = malloc(threadCount * sizeof(pthread_t));
+    BatchJob* jobs = malloc(threadCount * sizeof(BatchJob));
+    if(threads == NULL || jobs == NULL) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    for(int t = 0; t < threadCount; ++t) {
+        jobs[t].text = text;
+        jobs[t].lineStart = lineStart;
+        jobs[t].results = results;
+        jobs[t].firstLine = lineCount * t / threadCount;
+        jobs[t].lastLine = lineCount * (t + 1) / threadCount;
+        if(pthread_create(&threads[t], NULL, runBatchJob, &jobs[t]) != 0) {
+            fprintf(stderr, "Failed to create thread %d\n", t);
+            exit(1);
+        }
+    }
+    for(int t = 0; t < threadCount; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - begin.tv_sec) + (end.tv_nsec - begin.tv_nsec) / 1e9;
+
+    size_t palindromes = 0;
+    for(size_t i = 0; i < lineCount; ++i) {
+        printf("%zu\t%d\t%zu\t%zu\n", i + 1, results[i].palindrome,
+               results[i].longestStart, results[i].longestLength);
+        palindromes += results[i].palindrome;
+    }
+
+    fprintf(stderr, "%zu lines, %zu palindromes, %d threads, %.3f s, %.0f lines/s, %.1f MB/s\n",
+            lineCount, palindromes, threadCount, seconds,
+            seconds > 0 ? lineCount / seconds : 0.0,
+            seconds > 0 ? size / seconds / 1e6 : 0.0);
+
+    free(jobs);
+    free(threads);
+    free(results);
+    free(lineStart);
+    if(size > 0) {
+        munmap((void*)text, size);
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        int threadCount = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+        return runBatch(argv[1], threadCount);
+    }
+
     printf("Enter a string: ");
     char* inputString = readString();
 
@@ -82,6 +297,11 @@ int main() {
         } else {
             printf("\"%s\" is not a palindrome\n", inputString);
         }
+
+        size_t start;
+        size_t length = longestPalindrome(inputString, strlen(inputString), &start);
+        printf("Longest palindromic substring: \"%.*s\"\n", (int)length, inputString + start);
+
         free(inputString);  // Free the input string
     } else {
         printf("Failed to read the input string.\n");
@@ -3,41 +3,11 @@
 #include <string.h>
 #include <ctype.h>
 
+#include "Palindrome.h"
+
 // Function to check if a string is a palindrome
 int isPalindrome(char* inputString) {
-    int length = strlen(inputString);
-
-    // Allocate memory for a cleaned version of the string
-    char* str = malloc((length + 1) * sizeof(char));
-    if (str == NULL) {
-        printf("Memory allocation failed!\n");
-        return 0;
-    }
-
-    int index = 0;
-    // Normalize the input string: remove non-alphanumeric characters and convert to lowercase
-    for (int i = 0; i < length; ++i) {
-        if (isalnum((unsigned char)inputString[i])) {  // Use inputString here
-            str[index++] = tolower((unsigned char)inputString[i]);
-        }
-    }
-    str[index] = '\0';  // Null-terminate the cleaned string
-
-    // Check for palindrome using two-pointer technique
-    int left = 0;
-    int right = index - 1;
-
-    while (left < right) {
-        if (str[left] != str[right]) {
-            free(str);  // Free the allocated memory
-            return 0;   // Not a palindrome
-        }
-        left++;
-        right--;
-    }
-
-    free(str);  // Free the allocated memory
-    return 1;   // It's a palindrome
+    return isPalindromeLength(inputString, strlen(inputString));
 }
 
 // Function to read the input from the user
@@ -2,24 +2,10 @@
 #include <ctype.h>
 #include <string.h>
 
-int is_palindrome(const char *str) {
-    const char *left = str;
-    const char *right = str + strlen(str) - 1;
-
-    while (left < right) {
-        // Skip non-alphanumeric characters
-        while (left < right && !isalnum(*left)) left++;
-        while (left < right && !isalnum(*right)) right--;
-
-        // Compare characters in lowercase
-        if (tolower(*left) != tolower(*right)) {
-            return 0; // Not a palindrome
-        }
+#include "Palindrome.h"
 
-        left++;
-        right--;
-    }
-    return 1; // It's a palindrome
+int is_palindrome(const char *str) {
+    return isPalindromeLength(str, strlen(str));
 }
 
 int main() {
@@ -2,6 +2,161 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "Utf8.h"
+
+/*
+   - Blocks are reversed with one byte shuffle (pshufb) instead of byte-by-byte copies.
+   - In place, a block from the front and a block from the back are both reversed and stored in each
+     other's position, so the two ends move towards the middle 16 or 32 bytes per step.
+   - The leftover middle (shorter than one block pair) is swapped byte by byte.
+*/
+#if defined(__SSSE3__)
+static inline __m128i reverse_block16(__m128i block) {
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    return _mm_shuffle_epi8(block, reverse);
+}
+#endif
+
+#if defined(__AVX2__)
+static inline __m256i reverse_block32(__m256i block) {
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    // pshufb only works within 128-bit lanes, so swap the lanes afterwards
+    return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(block, reverse), 0x4E);
+}
+#endif
+
+// Reverse the first len bytes of str in place
+void reverse_in_place(char* str, size_t len) {
+    char* front = str;
+    char* back = str + len;
+
+#if defined(__AVX2__)
+    while(back - front >= 64) {
+        back -= 32;
+        __m256i head = _mm256_loadu_si256((const __m256i*)front);
+        __m256i tail = _mm256_loadu_si256((const __m256i*)back);
+        _mm256_storeu_si256((__m256i*)front, reverse_block32(tail));
+        _mm256_storeu_si256((__m256i*)back, reverse_block32(head));
+        front += 32;
+    }
+#endif
+#if defined(__SSSE3__)
+    while(back - front >= 32) {
+        back -= 16;
+        __m128i head = _mm_loadu_si128((const __m128i*)front);
+        __m128i tail = _mm_loadu_si128((const __m128i*)back);
+        _mm_storeu_si128((__m128i*)front, reverse_block16(tail));
+        _mm_storeu_si128((__m128i*)back, reverse_block16(head));
+        front += 16;
+    }
+#endif
+
+    while(back - front > 1) {
+        back--;
+        char temp = *front;
+        *front = *back;
+        *back = temp;
+        front++;
+    }
+}
+
+// Write the first len bytes of src into dest in reverse order; dest must not overlap src
+void reverse_into(char* dest, const char* src, size_t len) {
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for(; i + 32 <= len; i += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(src + len - i - 32));
+        _mm256_storeu_si256((__m256i*)(dest + i), reverse_block32(block));
+    }
+#endif
+#if defined(__SSSE3__)
+    for(; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(src + len - i - 16));
+        _mm_storeu_si128((__m128i*)(dest + i), reverse_block16(block));
+    }
+#endif
+
+    for(; i < len; i++) {
+        dest[i] = src[len - i - 1];
+    }
+}
+
+/*
+   - UTF-8 mode reverses by code point: the bytes are reversed first, which leaves every multi-byte
+     sequence backwards (continuation bytes followed by the lead byte), and then each such sequence
+     is flipped back.
+   - Runs of plain ASCII are skipped 16 bytes at a time.
+   - Malformed sequences (a continuation run that doesn't end in a lead byte of matching length) are
+     left byte-reversed rather than guessed at.
+*/
+static int utf8_sequence_length(unsigned char lead) {
+    if(lead >= 0xF0 && lead < 0xF8) return 4;
+    if(lead >= 0xE0) return lead < 0xF0 ? 3 : 0;
+    if(lead >= 0xC0) return 2;
+    return 0;
+}
+
+static void fix_reversed_utf8(char* str, size_t len) {
+    size_t i = 0;
+
+    while(i < len) {
+#if defined(__SSSE3__)
+        // Skip ASCII blocks
+        if(i + 16 <= len && _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + i))) == 0) {
+            i += 16;
+            continue;
+        }
+#endif
+        unsigned char c = (unsigned char)str[i];
+        if((c & 0xC0) != 0x80) {
+            i++;
+            continue;
+        }
+
+        // A run of continuation bytes, expected to end with its lead byte
+        size_t start = i;
+        while(i < len && ((unsigned char)str[i] & 0xC0) == 0x80) {
+            i++;
+        }
+        if(i < len && utf8_sequence_length((unsigned char)str[i]) == (int)(i - start + 1)) {
+            reverse_in_place(str + start, i - start + 1);
+            i++;
+        }
+    }
+}
+
+// Reverse a UTF-8 string of len bytes in place, keeping multi-byte code points intact
+void reverse_utf8_in_place(char* str, size_t len) {
+    reverse_in_place(str, len);
+    fix_reversed_utf8(str, len);
+}
+
+// Write the code-point reversal of a UTF-8 string of len bytes into dest
+void reverse_utf8_into(char* dest, const char* src, size_t len) {
+    reverse_into(dest, src, len);
+    fix_reversed_utf8(dest, len);
+}
+
+/*
+   - Reverses only the code points [first, first + count), leaving the rest of the string in place.
+   - The input is validated first, so the result is valid UTF-8 as well; returns 0 without touching
+     the string if it is not valid UTF-8.
+*/
+int reverse_utf8_range(char* str, size_t len, size_t first, size_t count) {
+    if(!utf8Validate(str, len)) {
+        return 0;
+    }
+    size_t from = utf8Offset(str, len, first);
+    size_t to = from + utf8Offset(str + from, len - from, count);
+    reverse_utf8_in_place(str + from, to - from);
+    return 1;
+}
+
 char* reverse_string(const char* str) {
     size_t len = strlen(str);
     char* reversed = (char*)malloc((len + 1) * sizeof(char));
@@ -11,9 +166,7 @@ char* reverse_string(const char* str) {
         return NULL;
     }
 
-    for(size_t i = 0; i < len; i++) {
-        reversed[i] = str[len - i - 1];
-    }
+    reverse_into(reversed, str, len);
     reversed[len] = '\0';
 
     return reversed;
@@ -28,5 +181,23 @@ int main() {
         printf("Reversed: %s\n", reversed);
         free(reversed);
     }
+
+    // In place, no allocation
+    char buffer[] = "Reversing a buffer in place with byte shuffles";
+    reverse_in_place(buffer, strlen(buffer));
+    printf("In place: %s\n", buffer);
+
+    // UTF-8 aware: "héllo wörld ✓" keeps its accented letters and the check mark intact
+    char utf8[] = "h\xC3\xA9llo w\xC3\xB6rld \xE2\x9C\x93";
+    reverse_utf8_in_place(utf8, strlen(utf8));
+    printf("UTF-8 reversed: %s\n", utf8);
+
+    // Only the second word, counted in code points: "héllo wörld" -> "héllo dlröw"
+    char words[] = "h\xC3\xA9llo w\xC3\xB6rld";
+    size_t words_len = strlen(words);
+    if(reverse_utf8_range(words, words_len, 6, 5)) {
+        printf("Code points 6-10 reversed: %s (%zu code points)\n", words, utf8Length(words, words_len));
+    }
+
     return 0;
-}
\ No newline at end of file
+}
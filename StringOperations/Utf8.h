@@ -0,0 +1,220 @@
+#ifndef UTF8_H
+#define UTF8_H
+
+/*
+   UTF-8 validation and code point counting, 16 bytes at a time, shared by ImplementSubstringFunction.c
+   and StringReversal.c. Everything is static inline, so each program that includes it gets its own copy
+   and no separate object file is needed.
+   - Validation uses the lookup-table method of Keiser and Lemire: every error in UTF-8 shows up in a
+     pair of adjacent bytes, and the top nibble of the first byte, its bottom nibble and the top nibble
+     of the second byte each select (via a 16-entry pshufb table) the error classes they are
+     compatible with. A pair is wrong exactly when all three lookups agree on some class.
+   - The third and fourth bytes of 3- and 4-byte sequences are checked separately: they must be
+     continuation bytes exactly when the byte 2 or 3 positions back is a 3- or 4-byte lead.
+   - Blocks of 64 ASCII bytes, the common case, are skipped with a single test of their high bits.
+   - Counting code points is counting bytes that are not continuation bytes (10xxxxxx).
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define UTF8_TOO_SHORT      (1 << 0)    // Lead byte followed by a lead byte or ASCII
+#define UTF8_TOO_LONG       (1 << 1)    // ASCII followed by a continuation byte
+#define UTF8_OVERLONG_3     (1 << 2)    // 11100000 100_____
+#define UTF8_TOO_LARGE      (1 << 3)    // Above U+10FFFF
+#define UTF8_SURROGATE      (1 << 4)    // 11101101 101_____, U+D800..U+DFFF
+#define UTF8_OVERLONG_2     (1 << 5)    // 1100000_ 10______
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4     (1 << 6)    // 11110000 1000____
+#define UTF8_TWO_CONTS      (1 << 7)    // Continuation byte without a lead byte
+#define UTF8_CARRY          (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+
+#if defined(__SSSE3__)
+static inline __m128i utf8BlockErrors(__m128i input, __m128i previous) {
+    const __m128i byte1HighTable = _mm_setr_epi8(
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,
+        (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS, (char)UTF8_TWO_CONTS,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_2,
+        UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,
+        UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4);
+    const __m128i byte1LowTable = _mm_setr_epi8(
+        (char)(UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4),
+        (char)(UTF8_CARRY | UTF8_OVERLONG_2),
+        (char)UTF8_CARRY,
+        (char)UTF8_CARRY,
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000),
+        (char)(UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000));
+    const __m128i byte2HighTable = _mm_setr_epi8(
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 |
+               UTF8_OVERLONG_4),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+        (char)(UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE),
+        UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT);
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+
+    // prev1: each byte's predecessor, reaching into the previous block for the first one
+    __m128i prev1 = _mm_alignr_epi8(input, previous, 15);
+    __m128i special = _mm_and_si128(
+        _mm_and_si128(_mm_shuffle_epi8(byte1HighTable, _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibble)),
+                      _mm_shuffle_epi8(byte1LowTable, _mm_and_si128(prev1, lowNibble))),
+        _mm_shuffle_epi8(byte2HighTable, _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble)));
+
+    // Bytes 2 or 3 after a 3- or 4-byte lead must be continuations; special has 0x80 set for those
+    __m128i prev2 = _mm_alignr_epi8(input, previous, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, previous, 13);
+    __m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)),
+                                  _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80)));
+    return _mm_xor_si128(_mm_and_si128(must23, _mm_set1_epi8((char)0x80)), special);
+}
+#endif
+
+// Byte-at-a-time validation, for machines without SSSE3 and as the baseline of ImplementSubstringFunction's benchmark
+static inline int utf8ValidateScalar(const unsigned char* str, size_t len) {
+    size_t i = 0;
+    while(i < len) {
+        unsigned char c = str[i];
+        if(c < 0x80) {
+            i++;
+            continue;
+        }
+        size_t need;
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        if(c >= 0xC2 && c <= 0xDF) {
+            need = 1;
+        }
+        else if(c >= 0xE0 && c <= 0xEF) {
+            need = 2;
+            if(c == 0xE0) low = 0xA0;           // Overlong
+            if(c == 0xED) high = 0x9F;          // Surrogates
+        }
+        else if(c >= 0xF0 && c <= 0xF4) {
+            need = 3;
+            if(c == 0xF0) low = 0x90;           // Overlong
+            if(c == 0xF4) high = 0x8F;          // Above U+10FFFF
+        }
+        else {
+            return 0;
+        }
+        if(len - i <= need || str[i + 1] < low || str[i + 1] > high) {
+            return 0;
+        }
+        for(size_t k = 2; k <= need; ++k) {
+            if((str[i + k] & 0xC0) != 0x80) {
+                return 0;
+            }
+        }
+        i += need + 1;
+    }
+    return 1;
+}
+
+// Is str[0, len) well-formed UTF-8?
+static inline int utf8Validate(const char* str, size_t len) {
+#if defined(__SSSE3__)
+    // A block ending in these lead bytes needs the next block to finish the sequence
+    const __m128i incompleteMax = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                (char)(0xF0 - 1), (char)(0xE0 - 1), (char)(0xC0 - 1));
+    __m128i previous = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+    size_t i = 0;
+
+    for(; i + 64 <= len; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(str + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(str + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(str + i + 48));
+        if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) == 0) {
+            // All ASCII: only a sequence left open by the previous block can be wrong
+            error = _mm_or_si128(error, incomplete);
+            incomplete = _mm_setzero_si128();
+            previous = d;
+            continue;
+        }
+        error = _mm_or_si128(error, utf8BlockErrors(a, previous));
+        error = _mm_or_si128(error, utf8BlockErrors(b, a));
+        error = _mm_or_si128(error, utf8BlockErrors(c, b));
+        error = _mm_or_si128(error, utf8BlockErrors(d, c));
+        incomplete = _mm_subs_epu8(d, incompleteMax);
+        previous = d;
+    }
+    for(; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(str + i));
+        error = _mm_or_si128(error, utf8BlockErrors(block, previous));
+        previous = block;
+    }
+
+    // The tail padded with zeros; the zeros also catch a sequence cut off by the end of the string
+    char tail[16] = {0};
+    memcpy(tail, str + i, len - i);
+    error = _mm_or_si128(error, utf8BlockErrors(_mm_loadu_si128((const __m128i*)tail), previous));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+#else
+    return utf8ValidateScalar((const unsigned char*)str, len);
+#endif
+}
+
+// Number of code points in str[0, len)
+static inline size_t utf8Length(const char* str, size_t len) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // As signed bytes, continuation bytes are -128..-65; everything else is greater
+    const __m128i limit = _mm_set1_epi8(-65);
+    for(; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(str + i));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(block, limit)));
+    }
+#endif
+    for(; i < len; ++i) {
+        count += (signed char)str[i] > -65;
+    }
+    return count;
+}
+
+// Byte offset where code point 'index' starts, or len if there are not that many
+static inline size_t utf8Offset(const char* str, size_t len, size_t index) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i limit = _mm_set1_epi8(-65);
+    for(; i + 16 <= len; i += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(str + i));
+        size_t starts = __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(block, limit)));
+        if(starts > index) {
+            break;
+        }
+        index -= starts;
+    }
+#endif
+    for(; i < len; ++i) {
+        if((signed char)str[i] > -65) {
+            if(index == 0) {
+                return i;
+            }
+            index--;
+        }
+    }
+    return len;
+}
+
+#endif
@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "../Instrumentation/Trace.h"
+
 // Function to read the input from user
 char* readString() {
     int bufferSize = 10;
@@ -37,6 +39,8 @@ char* readString() {
 }
 
 char* my_strstr(const char* haystack, const char* needle) {
+    TRACE_FUNCTION();
+
     // If needle is an empty string, return the haystack
     if(*needle == '\0') {
         return (char*)haystack;
@@ -44,6 +48,7 @@ char* my_strstr(const char* haystack, const char* needle) {
 
     // Iterate through the haystack
     while(*haystack != '\0') {
+        TRACE_BYTES(1);
         const char* h = haystack;
         const char* n = needle;
 